@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AnimNotifyState_MeleeSwing.h"
+#include "MeleeHitSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+
+UAnimNotifyState_MeleeSwing::UAnimNotifyState_MeleeSwing()
+{
+	WeaponBaseSocket = FName("WeaponBase");
+	WeaponTipSocket = FName("WeaponTip");
+	Radius = 12.0f;
+	Damage = 25.0f;
+}
+
+void UAnimNotifyState_MeleeSwing::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration)
+{
+	// No subsystem in the animation editor preview, so nothing gets hit there
+	if (UMeleeHitSubsystem* MeleeHits = UMeleeHitSubsystem::Get(MeshComp))
+	{
+		MeleeHits->BeginSwing(MeshComp, WeaponBaseSocket, WeaponTipSocket, Radius, Damage);
+	}
+}
+
+void UAnimNotifyState_MeleeSwing::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
+{
+	if (UMeleeHitSubsystem* MeleeHits = UMeleeHitSubsystem::Get(MeshComp))
+	{
+		MeleeHits->EndSwing(MeshComp);
+	}
+}
+
+FString UAnimNotifyState_MeleeSwing::GetNotifyName_Implementation() const
+{
+	return TEXT("Melee Swing");
+}
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "AnimNotifyState_MeleeSwing.generated.h"
+
+// Place over the part of an attack montage where the weapon can actually hit something
+UCLASS(meta = (DisplayName = "Melee Swing"))
+class TOPDOWNSTEALTH_API UAnimNotifyState_MeleeSwing : public UAnimNotifyState
+{
+	GENERATED_BODY()
+
+public:
+	UAnimNotifyState_MeleeSwing();
+
+	virtual void NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration) override;
+	virtual void NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override;
+	virtual FString GetNotifyName_Implementation() const override;
+
+	// Socket at the handle end of the weapon
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Melee)
+	FName WeaponBaseSocket;
+
+	// Socket at the striking end of the weapon
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Melee)
+	FName WeaponTipSocket;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Melee)
+	float Radius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Melee)
+	float Damage;
+};
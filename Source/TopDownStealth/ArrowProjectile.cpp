@@ -7,6 +7,9 @@
 #include "Components/StaticMeshComponent.h"
 #include "TopDownStealthCharacter.h"
 #include "Kismet/GameplayStatics.h"
+#include "SignificanceComponent.h"
+#include "FactionSubsystem.h"
+#include "GuardCharacter.h"
 
 // Sets default values
 AArrowProjectile::AArrowProjectile()
@@ -14,10 +17,13 @@ AArrowProjectile::AArrowProjectile()
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
+	bSwitchesTeam = false;
+
 	// Creating a sphere for basic collision handling
 	CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionComp"));
 	CollisionComp->BodyInstance.SetCollisionProfileName("Projectile");
 	CollisionComp->IgnoreActorWhenMoving(UGameplayStatics::GetPlayerPawn(GetWorld(), 0), true);
+	CollisionComp->OnComponentHit.AddDynamic(this, &AArrowProjectile::OnHit);
 
 	// Make that the root
 	RootComponent = CollisionComp;
@@ -34,6 +40,9 @@ AArrowProjectile::AArrowProjectile()
 	ProjectileMovement->bRotationFollowsVelocity = true;
 	ProjectileMovement->bShouldBounce = false;
 
+	Significance = CreateDefaultSubobject<USignificanceComponent>(TEXT("Significance"));
+	Significance->SignificanceTag = FName("Arrow");
+
 }
 
 // Called when the game starts or when spawned
@@ -50,3 +59,17 @@ void AArrowProjectile::Tick(float DeltaTime)
 
 }
 
+
+void AArrowProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
+{
+	AGuardCharacter* Guard = Cast<AGuardCharacter>(OtherActor);
+
+	// Bodies stay dead, switching them would put them back in the faction's member grid as targets
+	if (bSwitchesTeam && Guard && !Guard->bIsDead && Guard->Faction == EFaction::Guards)
+	{
+		if (UFactionSubsystem* Factions = UFactionSubsystem::Get(this))
+		{
+			Factions->SwitchFaction(Guard, (uint8)EFaction::Turncoats);
+		}
+	}
+}
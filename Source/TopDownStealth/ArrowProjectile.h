@@ -28,6 +28,13 @@ public:
 	// Returns ProjectileMovement subobject
 	FORCEINLINE class UProjectileMovementComponent* GetProjectileMovement() const { return ProjectileMovement; }
 
+	UFUNCTION()
+	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+	// Turns a guard it hits against the other guards
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+	bool bSwitchesTeam;
+
 private:
 	// Collision component
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Projectile, meta = (AllowPrivateAccess = "true"))
@@ -40,4 +47,8 @@ private:
 	//Projectile movment component
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	class UProjectileMovementComponent* ProjectileMovement;
+
+	// Stops arrows stuck in walls off screen from ticking
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Optimization, meta = (AllowPrivateAccess = "true"))
+	class USignificanceComponent* Significance;
 };
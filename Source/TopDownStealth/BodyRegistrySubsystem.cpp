@@ -0,0 +1,217 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "BodyRegistrySubsystem.h"
+#include "TopDownStealth.h"
+#include "StealthLightingLibrary.h"
+#include "Engine/PointLight.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Body Sight Queries"), STAT_BodySightQueries, STATGROUP_TopDownStealth);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bodies"), STAT_Bodies, STATGROUP_TopDownStealth);
+
+static const int32 BodyPoolSize = 64;
+static const float BodyDecayCheckInterval = 1.0f;
+
+UBodyRegistrySubsystem::UBodyRegistrySubsystem()
+	: Grid(1000.0f)
+{
+	BodyLifetime = 300.0f;
+	DiscoveredLifetime = 60.0f;
+	DecayTimer = 0.0f;
+}
+
+UBodyRegistrySubsystem* UBodyRegistrySubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UBodyRegistrySubsystem>() : nullptr;
+}
+
+void UBodyRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Markers.SetNum(BodyPoolSize);
+	FreeIndices.Reserve(BodyPoolSize);
+	for (int32 i = BodyPoolSize - 1; i >= 0; i--)
+	{
+		FreeIndices.Add(i);
+	}
+
+	// Bodies belong to the level they died in
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UBodyRegistrySubsystem::OnWorldCleanup);
+}
+
+void UBodyRegistrySubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
+	Super::Deinitialize();
+}
+
+int32 UBodyRegistrySubsystem::AddBody(AActor* Body)
+{
+	UWorld* World = GetWorld();
+	if (!Body || !World)
+	{
+		return INDEX_NONE;
+	}
+
+	// Pool is full, the body that's been lying around the longest makes room
+	if (FreeIndices.Num() == 0)
+	{
+		int32 Oldest = 0;
+		for (int32 i = 1; i < Markers.Num(); i++)
+		{
+			if (Markers[i].TimeOfDeath < Markers[Oldest].TimeOfDeath)
+			{
+				Oldest = i;
+			}
+		}
+		RemoveBody(Oldest);
+	}
+
+	const int32 BodyIndex = FreeIndices.Pop(false);
+
+	TArray<AActor*> PointLights;
+	UGameplayStatics::GetAllActorsOfClass(World, APointLight::StaticClass(), PointLights);
+
+	FBodyMarker& Marker = Markers[BodyIndex];
+	Marker.Location = Body->GetActorLocation();
+	Marker.TimeOfDeath = World->GetTimeSeconds();
+	Marker.bDiscovered = false;
+	Marker.bInLight = UStealthLightingLibrary::IsLocationInLight(World, Marker.Location, PointLights, Body);
+	Marker.bInUse = true;
+
+	Grid.Update(BodyIndex, Marker.Location);
+	SET_DWORD_STAT(STAT_Bodies, GetNumBodies());
+
+	return BodyIndex;
+}
+
+int32 UBodyRegistrySubsystem::FindVisibleBody(AActor* Guard, float SightRadius, float SightHalfAngle)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BodySightQueries);
+
+	if (!Guard || Grid.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const FVector GuardLocation = Guard->GetActorLocation();
+	const FVector GuardForward = Guard->GetActorForwardVector();
+	const float MinDot = FMath::Cos(FMath::DegreesToRadians(SightHalfAngle));
+	const float SightRadiusSq = SightRadius * SightRadius;
+
+	// Cheap checks first, gathered so the line of sight traces can go nearest first
+	TArray<TPair<float, int32>, TInlineAllocator<16>> Candidates;
+	Grid.ForEachInRadius(GuardLocation, SightRadius, [&](int32 BodyIndex)
+	{
+		const FBodyMarker& Marker = Markers[BodyIndex];
+		if (Marker.bDiscovered || !Marker.bInLight)
+		{
+			return;
+		}
+
+		const FVector ToBody = Marker.Location - GuardLocation;
+		const float DistSq = ToBody.SizeSquared();
+		if (DistSq >= SightRadiusSq || FVector::DotProduct(ToBody.GetSafeNormal2D(), GuardForward.GetSafeNormal2D()) < MinDot)
+		{
+			return;
+		}
+
+		Candidates.Emplace(DistSq, BodyIndex);
+	});
+
+	Candidates.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key < B.Key; });
+
+	// A body behind a pillar shouldn't hide one in plain view further away, but the traces are capped
+	static const int32 MaxSightTraces = 4;
+	const int32 NumTraces = FMath::Min(Candidates.Num(), MaxSightTraces);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BodySight), false, Guard);
+	for (int32 i = 0; i < NumTraces; i++)
+	{
+		const int32 BodyIndex = Candidates[i].Value;
+		FHitResult Hit;
+		if (!GetWorld()->LineTraceSingleByChannel(Hit, GuardLocation, Markers[BodyIndex].Location, ECC_Visibility, QueryParams))
+		{
+			return BodyIndex;
+		}
+	}
+
+	return INDEX_NONE;
+}
+
+void UBodyRegistrySubsystem::MarkDiscovered(int32 BodyIndex)
+{
+	if (Markers.IsValidIndex(BodyIndex) && Markers[BodyIndex].bInUse)
+	{
+		Markers[BodyIndex].bDiscovered = true;
+	}
+}
+
+FVector UBodyRegistrySubsystem::GetBodyLocation(int32 BodyIndex) const
+{
+	return Markers.IsValidIndex(BodyIndex) ? Markers[BodyIndex].Location : FVector::ZeroVector;
+}
+
+void UBodyRegistrySubsystem::RemoveBody(int32 BodyIndex)
+{
+	FBodyMarker& Marker = Markers[BodyIndex];
+	if (!Marker.bInUse)
+	{
+		return;
+	}
+
+	Marker = FBodyMarker();
+	Grid.Remove(BodyIndex);
+	FreeIndices.Add(BodyIndex);
+}
+
+void UBodyRegistrySubsystem::Tick(float DeltaTime)
+{
+	DecayTimer -= DeltaTime;
+	if (DecayTimer > 0.0f)
+	{
+		return;
+	}
+	DecayTimer = BodyDecayCheckInterval;
+
+	const float Now = GetWorld() ? GetWorld()->GetTimeSeconds() : 0.0f;
+	for (int32 i = 0; i < Markers.Num(); i++)
+	{
+		const FBodyMarker& Marker = Markers[i];
+		if (Marker.bInUse && Now - Marker.TimeOfDeath > (Marker.bDiscovered ? DiscoveredLifetime : BodyLifetime))
+		{
+			RemoveBody(i);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_Bodies, GetNumBodies());
+}
+
+bool UBodyRegistrySubsystem::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject) && Grid.Num() > 0;
+}
+
+TStatId UBodyRegistrySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBodyRegistrySubsystem, STATGROUP_Tickables);
+}
+
+void UBodyRegistrySubsystem::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	for (int32 i = 0; i < Markers.Num(); i++)
+	{
+		RemoveBody(i);
+	}
+}
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "SpatialHashGrid.h"
+#include "BodyRegistrySubsystem.generated.h"
+
+// One downed guard, as far as the other guards' perception is concerned
+struct FBodyMarker
+{
+	FVector Location;
+	float TimeOfDeath;
+	bool bDiscovered;
+	// Lights don't move, so whether the body is lit is worked out once when it's added
+	bool bInLight;
+	bool bInUse;
+
+	FBodyMarker()
+		: Location(FVector::ZeroVector)
+		, TimeOfDeath(0.0f)
+		, bDiscovered(false)
+		, bInLight(false)
+		, bInUse(false)
+	{
+	}
+};
+
+/**
+ * Keeps downed guards in a fixed size pool with a spatial hash over it, so "can this guard see a body"
+ * only looks at bodies near the guard. Old bodies decay and their slots get reused.
+ */
+UCLASS()
+class TOPDOWNSTEALTH_API UBodyRegistrySubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UBodyRegistrySubsystem();
+
+	static UBodyRegistrySubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Records a body where the actor is, reusing the oldest slot if the pool is full. Returns the body index.
+	UFUNCTION(BlueprintCallable, Category = "Bodies")
+	int32 AddBody(AActor* Body);
+
+	// Index of the nearest undiscovered, lit body the guard can see, or -1. Only the 4 nearest candidates get a line of sight trace
+	UFUNCTION(BlueprintCallable, Category = "Bodies")
+	int32 FindVisibleBody(AActor* Guard, float SightRadius, float SightHalfAngle);
+
+	UFUNCTION(BlueprintCallable, Category = "Bodies")
+	void MarkDiscovered(int32 BodyIndex);
+
+	UFUNCTION(BlueprintPure, Category = "Bodies")
+	FVector GetBodyLocation(int32 BodyIndex) const;
+
+	UFUNCTION(BlueprintPure, Category = "Bodies")
+	int32 GetNumBodies() const { return Markers.Num() - FreeIndices.Num(); }
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+private:
+	void RemoveBody(int32 BodyIndex);
+
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	TArray<FBodyMarker> Markers;
+
+	TArray<int32> FreeIndices;
+
+	TSpatialHashGrid<int32> Grid;
+
+	// How long an undiscovered body stays before it's recycled
+	float BodyLifetime;
+
+	// Discovered bodies are already reported, so they go sooner
+	float DiscoveredLifetime;
+
+	float DecayTimer;
+
+	FDelegateHandle WorldCleanupHandle;
+};
@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "DynamicObstacleComponent.h"
+#include "TopDownStealth.h"
+#include "NavigationSystem.h"
+#include "NavAreas/NavArea_Null.h"
+#include "NavAreas/NavArea_Default.h"
+#include "TopDownRecastNavMesh.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Controller.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Nav Tiles Rebuilt"), STAT_NavTilesRebuilt, STATGROUP_TopDownStealth);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Nav Paths Patched"), STAT_NavPathsPatched, STATGROUP_TopDownStealth);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last Nav Tile Rebuild (ms)"), STAT_LastNavTileRebuildMs, STATGROUP_TopDownStealth);
+
+// How many obstacles have patched each path, it's only invalidated again when the last one lets go
+static TMap<const FNavigationPath*, int32> GPathPatchCounts;
+
+UDynamicObstacleComponent::UDynamicObstacleComponent()
+{
+	bStartBlocking = true;
+	bBlocking = true;
+	bWaitingForRebuild = false;
+	RebuildStartTime = 0.0;
+	RebuiltTiles = 0;
+
+	AreaClass = UNavArea_Null::StaticClass();
+}
+
+void UDynamicObstacleComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Done on register rather than BeginPlay so the editor bake never includes the closed gate or wall,
+	// Dynamic Modifiers Only rebuilds reuse the baked geometry and the doorway could never open.
+	// The owner's collision would also dirty a big chunk of navmesh every time it moves or gets destroyed
+	if (AActor* Owner = GetOwner())
+	{
+		TArray<UPrimitiveComponent*> Primitives;
+		Owner->GetComponents<UPrimitiveComponent>(Primitives);
+		for (UPrimitiveComponent* Primitive : Primitives)
+		{
+			Primitive->SetCanEverAffectNavigation(false);
+		}
+	}
+}
+
+void UDynamicObstacleComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	bBlocking = bStartBlocking;
+	SetAreaClass(bBlocking ? UNavArea_Null::StaticClass() : UNavArea_Default::StaticClass());
+}
+
+void UDynamicObstacleComponent::SetBlocking(bool bNewBlocking)
+{
+	if (bBlocking == bNewBlocking)
+	{
+		return;
+	}
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavSys)
+	{
+		return;
+	}
+
+	bBlocking = bNewBlocking;
+
+	PatchActivePaths(bBlocking);
+
+	ATopDownRecastNavMesh* NavMesh = GetNavMesh();
+	if (!bWaitingForRebuild)
+	{
+		bWaitingForRebuild = true;
+		RebuildStartTime = FPlatformTime::Seconds();
+		RebuiltTiles = 0;
+
+		if (NavMesh)
+		{
+			BoundNavMesh = NavMesh;
+			TilesRebuiltHandle = NavMesh->OnTilesRebuilt.AddUObject(this, &UDynamicObstacleComponent::OnTilesRebuilt);
+		}
+	}
+
+	// Only the tiles under our bounds get marked dirty, the generator rebuilds them on worker threads
+	if (NavMesh)
+	{
+		TArray<FBox> Bounds;
+		Bounds.Add(GetNavigationBounds());
+		TArray<int32> Tiles;
+		NavMesh->GetNavMeshTilesIn(Bounds, Tiles);
+		for (int32 Tile : Tiles)
+		{
+			PendingTiles.Add((uint32)Tile);
+		}
+	}
+
+	SetAreaClass(bBlocking ? UNavArea_Null::StaticClass() : UNavArea_Default::StaticClass());
+
+	GetWorld()->GetTimerManager().SetTimer(RebuildCheckTimerHandle, this, &UDynamicObstacleComponent::CheckRebuildFinished, 0.5f, true);
+}
+
+void UDynamicObstacleComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Dissolved obstacles usually go before the rebuild finishes, the paths mustn't stay patched
+	StopWaitingForRebuild();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UDynamicObstacleComponent::OnTilesRebuilt(ATopDownRecastNavMesh* NavMesh, const TArray<uint32>& ChangedTiles)
+{
+	// Other obstacles' rebuilds come through here too, only our own tiles count
+	for (uint32 Tile : ChangedTiles)
+	{
+		if (PendingTiles.Remove(Tile) > 0)
+		{
+			RebuiltTiles++;
+		}
+	}
+
+	if (!bWaitingForRebuild || RebuiltTiles == 0 || PendingTiles.Num() > 0)
+	{
+		return;
+	}
+
+	const float RebuildMs = (float)((FPlatformTime::Seconds() - RebuildStartTime) * 1000.0);
+
+	SET_FLOAT_STAT(STAT_LastNavTileRebuildMs, RebuildMs);
+	INC_DWORD_STAT_BY(STAT_NavTilesRebuilt, RebuiltTiles);
+	UE_LOG(LogTopDownStealth, Log, TEXT("%s: rebuilt %d nav tiles in %.2f ms"), *GetOwner()->GetName(), RebuiltTiles, RebuildMs);
+
+	StopWaitingForRebuild();
+}
+
+void UDynamicObstacleComponent::CheckRebuildFinished()
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavSys || (!NavSys->IsNavigationBuildInProgress() && !NavSys->HasDirtyAreasQueued()))
+	{
+		StopWaitingForRebuild();
+	}
+}
+
+void UDynamicObstacleComponent::StopWaitingForRebuild()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(RebuildCheckTimerHandle);
+	}
+
+	if (ATopDownRecastNavMesh* NavMesh = BoundNavMesh.Get())
+	{
+		NavMesh->OnTilesRebuilt.Remove(TilesRebuiltHandle);
+	}
+	BoundNavMesh.Reset();
+	TilesRebuiltHandle.Reset();
+
+	bWaitingForRebuild = false;
+	PendingTiles.Reset();
+
+	ReleasePatchedPaths();
+}
+
+void UDynamicObstacleComponent::PatchActivePaths(bool bNowBlocking)
+{
+	// Paths only need recomputing if the obstacle closed and the path goes through it, opening never breaks a path
+	const FBox ObstacleBounds = GetNavigationBounds().ExpandBy(50.0f);
+
+	for (FConstControllerIterator It = GetWorld()->GetControllerIterator(); It; ++It)
+	{
+		AController* Controller = It->Get();
+		UPathFollowingComponent* PathFollowing = Controller ? Controller->FindComponentByClass<UPathFollowingComponent>() : nullptr;
+		if (!PathFollowing || !PathFollowing->HasValidPath())
+		{
+			continue;
+		}
+
+		FNavPathSharedPtr Path = PathFollowing->GetPath();
+
+		bool bCrossesObstacle = false;
+		if (bNowBlocking)
+		{
+			const TArray<FNavPathPoint>& Points = Path->GetPathPoints();
+			for (int32 i = 1; i < Points.Num() && !bCrossesObstacle; i++)
+			{
+				const FVector Start = Points[i - 1].Location;
+				const FVector End = Points[i].Location;
+				bCrossesObstacle = FMath::LineBoxIntersection(ObstacleBounds, Start, End, End - Start);
+			}
+		}
+
+		const FNavigationPath* Key = Path.Get();
+		if (!bCrossesObstacle && !PatchedPaths.ContainsByPredicate([Key](const TPair<const FNavigationPath*, FNavPathWeakPtr>& Patched) { return Patched.Key == Key; }))
+		{
+			int32& Count = GPathPatchCounts.FindOrAdd(Key);
+			if (Count++ == 0)
+			{
+				Path->SetIgnoreInvalidation(true);
+			}
+			PatchedPaths.Emplace(Key, Path);
+			INC_DWORD_STAT(STAT_NavPathsPatched);
+		}
+	}
+}
+
+void UDynamicObstacleComponent::ReleasePatchedPaths()
+{
+	for (const TPair<const FNavigationPath*, FNavPathWeakPtr>& Patched : PatchedPaths)
+	{
+		int32* Count = GPathPatchCounts.Find(Patched.Key);
+		if (Count && --(*Count) > 0)
+		{
+			// Another obstacle's rebuild is still pending for this path
+			continue;
+		}
+		GPathPatchCounts.Remove(Patched.Key);
+
+		if (FNavPathSharedPtr Path = Patched.Value.Pin())
+		{
+			Path->SetIgnoreInvalidation(false);
+		}
+	}
+	PatchedPaths.Reset();
+}
+
+ATopDownRecastNavMesh* UDynamicObstacleComponent::GetNavMesh() const
+{
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	return NavSys ? Cast<ATopDownRecastNavMesh>(NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate)) : nullptr;
+}
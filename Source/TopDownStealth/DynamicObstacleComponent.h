@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavModifierComponent.h"
+#include "NavigationData.h"
+#include "DynamicObstacleComponent.generated.h"
+
+/**
+ * Put this on anything that changes walkable space at runtime (gates, walls that get dissolved).
+ * The owner's own geometry is excluded from navigation when the component is registered, so it never
+ * ends up in the editor bake, and this modifier blocks or frees the area instead. A change then only
+ * dirties the navmesh tiles under the obstacle. Needs an ATopDownRecastNavMesh with runtime generation set to
+ * Dynamic Modifiers Only, which is what Config/DefaultEngine.ini sets up.
+ */
+UCLASS(ClassGroup = (Navigation), meta = (BlueprintSpawnableComponent))
+class TOPDOWNSTEALTH_API UDynamicObstacleComponent : public UNavModifierComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDynamicObstacleComponent();
+
+	// Call when the gate opens/closes or the obstacle is dissolved
+	UFUNCTION(BlueprintCallable, Category = "Navigation")
+	void SetBlocking(bool bNewBlocking);
+
+	UFUNCTION(BlueprintPure, Category = "Navigation")
+	bool IsBlocking() const { return bBlocking; }
+
+	// Whether the obstacle blocks navigation when the level starts (closed gate, solid wall)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Navigation")
+	bool bStartBlocking;
+
+protected:
+	virtual void OnRegister() override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	// Counts the generator's rebuilt tiles against the ones under this obstacle, finishes when all of ours are done
+	void OnTilesRebuilt(class ATopDownRecastNavMesh* NavMesh, const TArray<uint32>& ChangedTiles);
+
+	// Fallback for when no generation runs for our change, so our tiles never report back
+	void CheckRebuildFinished();
+
+	// Unbinds from the navmesh and lets the patched paths be invalidated again
+	void StopWaitingForRebuild();
+
+	// Stops paths that this change can't break from being invalidated and recomputed
+	void PatchActivePaths(bool bNowBlocking);
+
+	void ReleasePatchedPaths();
+
+	class ATopDownRecastNavMesh* GetNavMesh() const;
+
+	bool bBlocking;
+
+	bool bWaitingForRebuild;
+
+	double RebuildStartTime;
+
+	FTimerHandle RebuildCheckTimerHandle;
+
+	// Tiles under the obstacle that haven't been rebuilt since the last change
+	TSet<uint32> PendingTiles;
+
+	int32 RebuiltTiles;
+
+	TWeakObjectPtr<class ATopDownRecastNavMesh> BoundNavMesh;
+
+	FDelegateHandle TilesRebuiltHandle;
+
+	// Keyed by the raw path too, so the shared patch count can be released after the path is gone
+	TArray<TPair<const FNavigationPath*, FNavPathWeakPtr>> PatchedPaths;
+};
@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FactionSubsystem.h"
+#include "TopDownStealth.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/Controller.h"
+#include "AIController.h"
+#include "Perception/AIPerceptionComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Faction Hostile Search"), STAT_FactionHostileSearch, STATGROUP_TopDownStealth);
+DECLARE_CYCLE_STAT(TEXT("Faction Refresh"), STAT_FactionRefresh, STATGROUP_TopDownStealth);
+
+static const float FactionRefreshInterval = 0.2f;
+
+UFactionSubsystem::UFactionSubsystem()
+{
+	FMemory::Memzero(HostileMasks, sizeof(HostileMasks));
+	RefreshTimer = 0.0f;
+}
+
+UFactionSubsystem* UFactionSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UFactionSubsystem>() : nullptr;
+}
+
+void UFactionSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SetHostile((uint8)EFaction::Player, (uint8)EFaction::Guards, true);
+	SetHostile((uint8)EFaction::Turncoats, (uint8)EFaction::Guards, true);
+
+	// AI perception asks this when deciding whether something it sees is an enemy
+	if (Instances.Num() == 0)
+	{
+		FGenericTeamId::SetAttitudeSolver(&UFactionSubsystem::SolveAttitude);
+	}
+	Instances.Add(this);
+}
+
+void UFactionSubsystem::Deinitialize()
+{
+	Instances.Remove(this);
+	if (Instances.Num() == 0)
+	{
+		FGenericTeamId::ResetAttitudeSolver();
+	}
+
+	for (int32 i = 0; i < MaxFactions; i++)
+	{
+		Members[i].Reset();
+	}
+	MemberFactions.Reset();
+
+	Super::Deinitialize();
+}
+
+void UFactionSubsystem::SetHostile(uint8 FactionA, uint8 FactionB, bool bHostile)
+{
+	if (FactionA >= MaxFactions || FactionB >= MaxFactions)
+	{
+		return;
+	}
+
+	if (bHostile)
+	{
+		HostileMasks[FactionA] |= (1u << FactionB);
+		HostileMasks[FactionB] |= (1u << FactionA);
+	}
+	else
+	{
+		HostileMasks[FactionA] &= ~(1u << FactionB);
+		HostileMasks[FactionB] &= ~(1u << FactionA);
+	}
+}
+
+TArray<UFactionSubsystem*> UFactionSubsystem::Instances;
+
+ETeamAttitude::Type UFactionSubsystem::SolveAttitude(FGenericTeamId A, FGenericTeamId B)
+{
+	// The solver gets no world, every instance starts with the same relations so the oldest one answers
+	return Instances.Num() > 0 ? Instances[0]->GetAttitude(A, B) : ETeamAttitude::Neutral;
+}
+
+ETeamAttitude::Type UFactionSubsystem::GetAttitude(FGenericTeamId A, FGenericTeamId B) const
+{
+	if (IsHostile(A.GetId(), B.GetId()))
+	{
+		return ETeamAttitude::Hostile;
+	}
+	return A == B ? ETeamAttitude::Friendly : ETeamAttitude::Neutral;
+}
+
+void UFactionSubsystem::RegisterMember(AActor* Actor)
+{
+	const IGenericTeamAgentInterface* TeamAgent = Cast<IGenericTeamAgentInterface>(Actor);
+	if (!TeamAgent)
+	{
+		return;
+	}
+
+	const uint8 Faction = TeamAgent->GetGenericTeamId().GetId();
+	if (Faction >= MaxFactions)
+	{
+		return;
+	}
+
+	UnregisterMember(Actor);
+	MemberFactions.Add(Actor, Faction);
+	Members[Faction].Update(Actor, Actor->GetActorLocation());
+}
+
+void UFactionSubsystem::UnregisterMember(AActor* Actor)
+{
+	uint8 Faction;
+	if (MemberFactions.RemoveAndCopyValue(Actor, Faction))
+	{
+		Members[Faction].Remove(Actor);
+	}
+}
+
+void UFactionSubsystem::SwitchFaction(AActor* Actor, uint8 NewFaction)
+{
+	IGenericTeamAgentInterface* TeamAgent = Cast<IGenericTeamAgentInterface>(Actor);
+	if (!TeamAgent || NewFaction >= MaxFactions)
+	{
+		return;
+	}
+
+	TeamAgent->SetGenericTeamId(FGenericTeamId(NewFaction));
+
+	SyncControllerTeam(Cast<APawn>(Actor));
+
+	RegisterMember(Actor);
+}
+
+void UFactionSubsystem::SyncControllerTeam(APawn* Pawn)
+{
+	IGenericTeamAgentInterface* PawnAgent = Cast<IGenericTeamAgentInterface>(Pawn);
+	IGenericTeamAgentInterface* ControllerAgent = Pawn ? Cast<IGenericTeamAgentInterface>(Pawn->GetController()) : nullptr;
+	if (!PawnAgent || !ControllerAgent)
+	{
+		return;
+	}
+
+	ControllerAgent->SetGenericTeamId(PawnAgent->GetGenericTeamId());
+
+	// The perception system caches the listener's team, so it has to be told it changed
+	if (AAIController* AIController = Cast<AAIController>(Pawn->GetController()))
+	{
+		if (UAIPerceptionComponent* Perception = AIController->GetAIPerceptionComponent())
+		{
+			Perception->RequestStimuliListenerUpdate();
+		}
+	}
+}
+
+AActor* UFactionSubsystem::FindNearestHostile(AActor* Seeker, float Radius) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_FactionHostileSearch);
+
+	const uint8* SeekerFaction = Seeker ? MemberFactions.Find(Seeker) : nullptr;
+	if (!SeekerFaction)
+	{
+		return nullptr;
+	}
+
+	const FVector SeekerLocation = Seeker->GetActorLocation();
+	float BestDistSq = Radius * Radius;
+	AActor* Best = nullptr;
+
+	// Only the factions we're hostile to, and only their cells around us
+	uint32 Hostiles = HostileMasks[*SeekerFaction];
+	while (Hostiles != 0)
+	{
+		const int32 Faction = FMath::CountTrailingZeros(Hostiles);
+		Hostiles &= Hostiles - 1;
+
+		Members[Faction].ForEachInRadius(SeekerLocation, Radius, [&](const TWeakObjectPtr<AActor>& Member)
+		{
+			AActor* Candidate = Member.Get();
+			if (!Candidate)
+			{
+				return;
+			}
+
+			const float DistSq = FVector::DistSquared(Candidate->GetActorLocation(), SeekerLocation);
+			if (DistSq < BestDistSq)
+			{
+				BestDistSq = DistSq;
+				Best = Candidate;
+			}
+		});
+	}
+
+	return Best;
+}
+
+void UFactionSubsystem::Tick(float DeltaTime)
+{
+	RefreshTimer -= DeltaTime;
+	if (RefreshTimer > 0.0f)
+	{
+		return;
+	}
+	RefreshTimer = FactionRefreshInterval;
+
+	SCOPE_CYCLE_COUNTER(STAT_FactionRefresh);
+
+	for (auto It = MemberFactions.CreateIterator(); It; ++It)
+	{
+		if (AActor* Actor = It.Key().Get())
+		{
+			Members[It.Value()].Update(It.Key(), Actor->GetActorLocation());
+		}
+		else
+		{
+			Members[It.Value()].Remove(It.Key());
+			It.RemoveCurrent();
+		}
+	}
+}
+
+bool UFactionSubsystem::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject) && MemberFactions.Num() > 0;
+}
+
+TStatId UFactionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFactionSubsystem, STATGROUP_Tickables);
+}
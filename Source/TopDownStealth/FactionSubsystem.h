@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "GenericTeamAgentInterface.h"
+#include "SpatialHashGrid.h"
+#include "FactionSubsystem.generated.h"
+
+// Team ids used as FGenericTeamId, so the AI perception attitude checks use them too
+UENUM(BlueprintType)
+enum class EFaction : uint8
+{
+	Player,
+	Guards,
+	// Guards hit by a team switch arrow, they fight the other guards
+	Turncoats,
+	Neutral
+};
+
+/**
+ * Keeps who's hostile to who as one bitmask per faction, and every faction's members in their own
+ * spatial hash, so finding a target only looks at nearby members of hostile factions.
+ */
+UCLASS()
+class TOPDOWNSTEALTH_API UFactionSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static const int32 MaxFactions = 32;
+
+	UFactionSubsystem();
+
+	static UFactionSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Sets hostility both ways
+	UFUNCTION(BlueprintCallable, Category = "Factions")
+	void SetHostile(uint8 FactionA, uint8 FactionB, bool bHostile);
+
+	UFUNCTION(BlueprintPure, Category = "Factions")
+	bool IsHostile(uint8 FactionA, uint8 FactionB) const
+	{
+		return FactionA < MaxFactions && FactionB < MaxFactions && (HostileMasks[FactionA] & (1u << FactionB)) != 0;
+	}
+
+	// Actors that implement IGenericTeamAgentInterface call this on BeginPlay
+	void RegisterMember(AActor* Actor);
+
+	void UnregisterMember(AActor* Actor);
+
+	// Moves the actor to another faction, used by the team switch arrow
+	UFUNCTION(BlueprintCallable, Category = "Factions")
+	void SwitchFaction(AActor* Actor, uint8 NewFaction);
+
+	// Copies the pawn's team onto its controller, AI perception takes the listener's team from the controller
+	static void SyncControllerTeam(class APawn* Pawn);
+
+	// Closest member of a faction hostile to the seeker, or null if there's none within the radius
+	UFUNCTION(BlueprintCallable, Category = "Factions")
+	AActor* FindNearestHostile(AActor* Seeker, float Radius) const;
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+private:
+	ETeamAttitude::Type GetAttitude(FGenericTeamId A, FGenericTeamId B) const;
+
+	// The engine's attitude solver is one global for the whole process, this answers it for every game instance
+	static ETeamAttitude::Type SolveAttitude(FGenericTeamId A, FGenericTeamId B);
+
+	// Every initialized subsystem, more than one with multiplayer PIE. The solver is installed while this isn't empty
+	static TArray<UFactionSubsystem*> Instances;
+
+	// Bit N of HostileMasks[F] is set when faction F is hostile to faction N
+	uint32 HostileMasks[MaxFactions];
+
+	TSpatialHashGrid<TWeakObjectPtr<AActor>> Members[MaxFactions];
+
+	TMap<TWeakObjectPtr<AActor>, uint8> MemberFactions;
+
+	// Members move, so their cells are refreshed a few times a second rather than every frame
+	float RefreshTimer;
+};
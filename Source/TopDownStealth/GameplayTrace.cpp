@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GameplayTrace.h"
+#include "TopDownStealth.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<int32> CVarGameplayTraceEnabled(
+	TEXT("TopDown.Trace.Enabled"),
+	1,
+	TEXT("Records gameplay events into the trace ring buffers (0 = off)"));
+
+// Ring buffer owned by one thread. Only that thread writes to it, so Head is the only thing that needs to be atomic.
+struct FGameplayTraceBuffer
+{
+	// Power of two so wrapping is a mask
+	static const int32 Capacity = 4096;
+
+	FGameplayTraceRecord Records[Capacity];
+
+	// Total records ever written, the write position is Head & (Capacity - 1)
+	volatile int32 Head;
+
+	uint32 ThreadId;
+
+	FGameplayTraceBuffer* Next;
+};
+
+// Every thread's buffer, pushed on with a compare exchange. Buffers are never freed so a dump can always walk this.
+static FGameplayTraceBuffer* volatile GTraceBuffers = nullptr;
+
+static FDelegateHandle GTraceCrashHandle;
+
+static FGameplayTraceBuffer* GetThreadBuffer()
+{
+	static const uint32 TlsSlot = FPlatformTLS::AllocTlsSlot();
+
+	FGameplayTraceBuffer* Buffer = (FGameplayTraceBuffer*)FPlatformTLS::GetTlsValue(TlsSlot);
+	if (!Buffer)
+	{
+		Buffer = new FGameplayTraceBuffer();
+		Buffer->Head = 0;
+		Buffer->ThreadId = FPlatformTLS::GetCurrentThreadId();
+
+		FGameplayTraceBuffer* OldHead;
+		do
+		{
+			OldHead = GTraceBuffers;
+			Buffer->Next = OldHead;
+		}
+		while (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&GTraceBuffers, Buffer, OldHead) != OldHead);
+
+		FPlatformTLS::SetTlsValue(TlsSlot, Buffer);
+	}
+	return Buffer;
+}
+
+void FGameplayTrace::Record(EGameplayTraceEvent Event, const FVector& Location, int32 Payload)
+{
+	if (CVarGameplayTraceEnabled.GetValueOnAnyThread() == 0)
+	{
+		return;
+	}
+
+	FGameplayTraceBuffer* Buffer = GetThreadBuffer();
+	const int32 Index = Buffer->Head;
+
+	FGameplayTraceRecord& Record = Buffer->Records[Index & (FGameplayTraceBuffer::Capacity - 1)];
+	Record.Cycles = FPlatformTime::Cycles64();
+	Record.ThreadId = Buffer->ThreadId;
+	Record.Event = (uint8)Event;
+	Record.Payload = Payload;
+	Record.X = Location.X;
+	Record.Y = Location.Y;
+	Record.Z = Location.Z;
+
+	// Publish the record only after it's fully written
+	FPlatformAtomics::AtomicStore(&Buffer->Head, Index + 1);
+}
+
+// Writes the header and every buffer straight from the rings. Doesn't allocate, so it's safe on the crash path.
+static bool WriteTrace(IFileHandle* File)
+{
+	// Records a thread is writing right now could be torn, so leave a bit of slack behind each head
+	static const int32 WriteSlack = 64;
+
+	FGameplayTraceFileHeader Header;
+	Header.Magic = FGameplayTraceFileHeader::ExpectedMagic;
+	Header.Version = FGameplayTraceFileHeader::ExpectedVersion;
+	Header.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+	Header.NumRecords = 0;
+	Header.Padding = 0;
+
+	// The count isn't known until the buffers have been written, so the header is written again at the end
+	bool bWritten = File->Seek(0) && File->Write((const uint8*)&Header, sizeof(Header));
+
+	for (FGameplayTraceBuffer* Buffer = GTraceBuffers; Buffer && bWritten; Buffer = Buffer->Next)
+	{
+		const int32 Head = FPlatformAtomics::AtomicRead(&Buffer->Head);
+		const int32 First = FMath::Max(Head - FGameplayTraceBuffer::Capacity + WriteSlack, 0);
+		const int32 Count = Head - First;
+		if (Count <= 0)
+		{
+			continue;
+		}
+
+		// At most two runs, up to the end of the ring and then from its start
+		const int32 Start = First & (FGameplayTraceBuffer::Capacity - 1);
+		const int32 FirstRun = FMath::Min(Count, FGameplayTraceBuffer::Capacity - Start);
+		bWritten = File->Write((const uint8*)&Buffer->Records[Start], FirstRun * sizeof(FGameplayTraceRecord));
+		if (bWritten && Count > FirstRun)
+		{
+			bWritten = File->Write((const uint8*)&Buffer->Records[0], (Count - FirstRun) * sizeof(FGameplayTraceRecord));
+		}
+		Header.NumRecords += Count;
+	}
+
+	bWritten = bWritten && File->Seek(0) && File->Write((const uint8*)&Header, sizeof(Header));
+	return bWritten && File->Flush();
+}
+
+// Opened at startup so a crash doesn't have to allocate, format a name or create directories
+static IFileHandle* GCrashDumpFile = nullptr;
+static FString GCrashDumpFilename;
+static bool GCrashDumpWritten = false;
+
+bool FGameplayTrace::Dump(const FString& Filename)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+
+	IFileHandle* File = PlatformFile.OpenWrite(*Filename);
+	if (!File)
+	{
+		return false;
+	}
+
+	const bool bWritten = WriteTrace(File);
+	delete File;
+
+	return bWritten;
+}
+
+FString FGameplayTrace::GetDefaultDumpFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Traces") / FString::Printf(TEXT("Gameplay-%s.gtrace"), *FDateTime::Now().ToString());
+}
+
+const TCHAR* FGameplayTrace::GetEventName(uint8 Event)
+{
+	switch ((EGameplayTraceEvent)Event)
+	{
+	case EGameplayTraceEvent::ArrowFired:
+		return TEXT("ArrowFired");
+	case EGameplayTraceEvent::PickupCollected:
+		return TEXT("PickupCollected");
+	case EGameplayTraceEvent::LightStateChanged:
+		return TEXT("LightStateChanged");
+	case EGameplayTraceEvent::PathRequested:
+		return TEXT("PathRequested");
+	case EGameplayTraceEvent::AIStateChanged:
+		return TEXT("AIStateChanged");
+	default:
+		return TEXT("Unknown");
+	}
+}
+
+static void DumpGameplayTraceOnCrash()
+{
+	if (GCrashDumpFile && !GCrashDumpWritten)
+	{
+		GCrashDumpWritten = true;
+		WriteTrace(GCrashDumpFile);
+	}
+}
+
+void FGameplayTrace::Startup()
+{
+	GCrashDumpFilename = FPaths::ProjectSavedDir() / TEXT("Traces") / FString::Printf(TEXT("Crash-%s.gtrace"), *FDateTime::Now().ToString());
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(GCrashDumpFilename));
+	GCrashDumpFile = PlatformFile.OpenWrite(*GCrashDumpFilename);
+
+	GTraceCrashHandle = FCoreDelegates::OnHandleSystemError.AddStatic(&DumpGameplayTraceOnCrash);
+}
+
+void FGameplayTrace::Shutdown()
+{
+	FCoreDelegates::OnHandleSystemError.Remove(GTraceCrashHandle);
+
+	// Nothing crashed, don't leave an empty crash dump behind
+	if (GCrashDumpFile)
+	{
+		delete GCrashDumpFile;
+		GCrashDumpFile = nullptr;
+
+		if (!GCrashDumpWritten)
+		{
+			FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*GCrashDumpFilename);
+		}
+	}
+}
+
+static void DumpGameplayTraceCommand(const TArray<FString>& Args)
+{
+	const FString Filename = Args.Num() > 0 ? Args[0] : FGameplayTrace::GetDefaultDumpFilename();
+
+	if (FGameplayTrace::Dump(Filename))
+	{
+		UE_LOG(LogTopDownStealth, Display, TEXT("Gameplay trace written to %s"), *Filename);
+	}
+	else
+	{
+		UE_LOG(LogTopDownStealth, Warning, TEXT("Couldn't write gameplay trace to %s"), *Filename);
+	}
+}
+
+static FAutoConsoleCommand DumpGameplayTraceConsoleCommand(
+	TEXT("TopDown.Trace.Dump"),
+	TEXT("Writes the gameplay trace ring buffers to Saved/Traces, or to the given file"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&DumpGameplayTraceCommand));
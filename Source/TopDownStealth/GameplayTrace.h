@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EGameplayTraceEvent : uint8
+{
+	ArrowFired,
+	PickupCollected,
+	LightStateChanged,
+	PathRequested,
+	AIStateChanged,
+
+	Count
+};
+
+// One traced event, fixed size so the buffers and dump files are just arrays of these
+struct FGameplayTraceRecord
+{
+	uint64 Cycles;
+	uint32 ThreadId;
+	uint8 Event;
+	uint8 Padding[3];
+	int32 Payload;
+	float X;
+	float Y;
+	float Z;
+};
+
+static_assert(sizeof(FGameplayTraceRecord) == 32, "Trace records are written straight to disk, keep them 32 bytes");
+
+// Start of a trace dump file, followed by NumRecords records
+struct FGameplayTraceFileHeader
+{
+	static const uint32 ExpectedMagic = 0x43525447; // 'GTRC'
+	static const uint32 ExpectedVersion = 1;
+
+	uint32 Magic;
+	uint32 Version;
+	double SecondsPerCycle;
+	uint32 NumRecords;
+	uint32 Padding;
+};
+
+/**
+ * Low overhead event tracer. Every thread writes into its own ring buffer with no locks, and the
+ * buffers are only read when they're dumped (console command or crash).
+ */
+class TOPDOWNSTEALTH_API FGameplayTrace
+{
+public:
+	// Opens the crash dump file up front and hooks up the crash handler, called from the module
+	static void Startup();
+	static void Shutdown();
+
+	static void Record(EGameplayTraceEvent Event, const FVector& Location, int32 Payload = 0);
+
+	// Writes everything in the ring buffers to the file, returns false if it couldn't
+	static bool Dump(const FString& Filename);
+
+	static FString GetDefaultDumpFilename();
+
+	static const TCHAR* GetEventName(uint8 Event);
+};
+
+#define TRACE_GAMEPLAY_EVENT(Event, Location, Payload) FGameplayTrace::Record(EGameplayTraceEvent::Event, Location, Payload)
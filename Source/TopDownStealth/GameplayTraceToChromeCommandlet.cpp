@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GameplayTraceToChromeCommandlet.h"
+#include "TopDownStealth.h"
+#include "GameplayTrace.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+int32 UGameplayTraceToChromeCommandlet::Main(const FString& Params)
+{
+	FString InFilename;
+	if (!FParse::Value(*Params, TEXT("In="), InFilename))
+	{
+		UE_LOG(LogTopDownStealth, Error, TEXT("Usage: -run=GameplayTraceToChrome -In=<dump.gtrace> [-Out=<trace.json>]"));
+		return 1;
+	}
+
+	FString OutFilename;
+	if (!FParse::Value(*Params, TEXT("Out="), OutFilename))
+	{
+		OutFilename = FPaths::ChangeExtension(InFilename, TEXT("json"));
+	}
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *InFilename))
+	{
+		UE_LOG(LogTopDownStealth, Error, TEXT("Couldn't read %s"), *InFilename);
+		return 1;
+	}
+
+	if (Data.Num() < (int32)sizeof(FGameplayTraceFileHeader))
+	{
+		UE_LOG(LogTopDownStealth, Error, TEXT("%s is too small to be a gameplay trace"), *InFilename);
+		return 1;
+	}
+
+	FGameplayTraceFileHeader Header;
+	FMemory::Memcpy(&Header, Data.GetData(), sizeof(Header));
+
+	const int64 ExpectedSize = sizeof(Header) + (int64)Header.NumRecords * sizeof(FGameplayTraceRecord);
+	if (Header.Magic != FGameplayTraceFileHeader::ExpectedMagic || Header.Version != FGameplayTraceFileHeader::ExpectedVersion || Data.Num() < ExpectedSize)
+	{
+		UE_LOG(LogTopDownStealth, Error, TEXT("%s is not a version %u gameplay trace"), *InFilename, FGameplayTraceFileHeader::ExpectedVersion);
+		return 1;
+	}
+
+	TArray<FGameplayTraceRecord> Records;
+	Records.SetNumUninitialized(Header.NumRecords);
+	FMemory::Memcpy(Records.GetData(), Data.GetData() + sizeof(Header), Header.NumRecords * sizeof(FGameplayTraceRecord));
+
+	// Each thread's buffer is in order, but the threads are dumped one after another
+	Records.Sort([](const FGameplayTraceRecord& A, const FGameplayTraceRecord& B) { return A.Cycles < B.Cycles; });
+
+	const uint64 BaseCycles = Records.Num() > 0 ? Records[0].Cycles : 0;
+
+	FString Json;
+	Json.Reserve(Records.Num() * 160);
+	Json += TEXT("{\"traceEvents\":[\n");
+
+	for (int32 i = 0; i < Records.Num(); i++)
+	{
+		const FGameplayTraceRecord& Record = Records[i];
+		const double Microseconds = (double)(Record.Cycles - BaseCycles) * Header.SecondsPerCycle * 1000000.0;
+
+		Json += FString::Printf(TEXT("{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"payload\":%d,\"x\":%.1f,\"y\":%.1f,\"z\":%.1f}}%s\n"),
+			FGameplayTrace::GetEventName(Record.Event), Record.ThreadId, Microseconds, Record.Payload, Record.X, Record.Y, Record.Z,
+			i + 1 < Records.Num() ? TEXT(",") : TEXT(""));
+	}
+
+	Json += TEXT("]}\n");
+
+	if (!FFileHelper::SaveStringToFile(Json, *OutFilename))
+	{
+		UE_LOG(LogTopDownStealth, Error, TEXT("Couldn't write %s"), *OutFilename);
+		return 1;
+	}
+
+	UE_LOG(LogTopDownStealth, Display, TEXT("Wrote %d events to %s"), Records.Num(), *OutFilename);
+	return 0;
+}
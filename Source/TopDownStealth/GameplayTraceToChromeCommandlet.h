@@ -0,0 +1,20 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GameplayTraceToChromeCommandlet.generated.h"
+
+/**
+ * Converts a gameplay trace dump into Chrome trace JSON (chrome://tracing or ui.perfetto.dev).
+ * Usage: UE4Editor-Cmd TopDownStealth.uproject -run=GameplayTraceToChrome -In=<dump.gtrace> [-Out=<trace.json>]
+ */
+UCLASS()
+class UGameplayTraceToChromeCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	virtual int32 Main(const FString& Params) override;
+};
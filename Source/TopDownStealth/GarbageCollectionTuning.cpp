@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GarbageCollectionTuning.h"
+#include "TopDownStealth.h"
+#include "HAL/IConsoleManager.h"
+#include "StatsReader.h"
+#include "Containers/Ticker.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Garbage Collections"), STAT_GarbageCollections, STATGROUP_TopDownStealth);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last GC Mark (ms)"), STAT_LastGCMarkMs, STATGROUP_TopDownStealth);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last GC Mark + Full Purge (ms)"), STAT_LastGCFullPurgeMs, STATGROUP_TopDownStealth);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Last GC Purge Frame (ms)"), STAT_LastGCPurgeFrameMs, STATGROUP_TopDownStealth);
+
+static FGarbageCollectionReport GReport;
+static double GCollectStartTime = 0.0;
+static FDelegateHandle GPreCollectHandle;
+static FDelegateHandle GPostCollectHandle;
+static FDelegateHandle GPurgeTickerHandle;
+
+static void OnPreGarbageCollect()
+{
+	GCollectStartTime = FPlatformTime::Seconds();
+}
+
+static void OnPostGarbageCollect()
+{
+	const double CollectMs = (FPlatformTime::Seconds() - GCollectStartTime) * 1000.0;
+
+	INC_DWORD_STAT(STAT_GarbageCollections);
+
+	// Post collect fires after the purge when the collection did a full one, that time isn't just marking
+	if (IsIncrementalPurgePending())
+	{
+		GReport.Collections++;
+		GReport.TotalMarkMs += CollectMs;
+		GReport.MaxMarkMs = FMath::Max(GReport.MaxMarkMs, CollectMs);
+		SET_FLOAT_STAT(STAT_LastGCMarkMs, CollectMs);
+	}
+	else
+	{
+		GReport.FullPurgeCollections++;
+		GReport.MaxFullPurgeCollectMs = FMath::Max(GReport.MaxFullPurgeCollectMs, CollectMs);
+		SET_FLOAT_STAT(STAT_LastGCFullPurgeMs, CollectMs);
+	}
+}
+
+// The engine does the purging within its own per frame limit, this only reads back how long it took
+static bool MeasurePurge(float DeltaTime)
+{
+	if (IsIncrementalPurgePending())
+	{
+		static const FName PurgeStat(TEXT("STAT_IncrementalPurgeGarbage"));
+		const double PurgeMs = FStatsReader::GetLatestMs(PurgeStat);
+
+		GReport.PurgeFrames++;
+		GReport.TotalPurgeMs += PurgeMs;
+		GReport.MaxPurgeFrameMs = FMath::Max(GReport.MaxPurgeFrameMs, PurgeMs);
+		SET_FLOAT_STAT(STAT_LastGCPurgeFrameMs, PurgeMs);
+	}
+	return true;
+}
+
+static void ReportGarbageCollection()
+{
+	const double AverageMarkMs = GReport.Collections > 0 ? GReport.TotalMarkMs / GReport.Collections : 0.0;
+
+	UE_LOG(LogTopDownStealth, Display, TEXT("GC: %d collections, mark %.2f ms avg / %.2f ms max, purge %.1f ms over %d frames / %.2f ms max frame, %d full purge collections %.2f ms max"),
+		GReport.Collections, AverageMarkMs, GReport.MaxMarkMs, GReport.TotalPurgeMs, GReport.PurgeFrames, GReport.MaxPurgeFrameMs,
+		GReport.FullPurgeCollections, GReport.MaxFullPurgeCollectMs);
+}
+
+static FAutoConsoleCommand ReportGarbageCollectionCommand(
+	TEXT("TopDown.GC.Report"),
+	TEXT("Prints garbage collection mark and purge times since startup or the last soak sample, purge times need stat gc on"),
+	FConsoleCommandDelegate::CreateStatic(&ReportGarbageCollection));
+
+void FGarbageCollectionTuning::Startup()
+{
+	GPreCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddStatic(&OnPreGarbageCollect);
+	GPostCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&OnPostGarbageCollect);
+	GPurgeTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&MeasurePurge));
+}
+
+void FGarbageCollectionTuning::Shutdown()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(GPreCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(GPostCollectHandle);
+	FTicker::GetCoreTicker().RemoveTicker(GPurgeTickerHandle);
+}
+
+const FGarbageCollectionReport& FGarbageCollectionTuning::GetReport()
+{
+	return GReport;
+}
+
+void FGarbageCollectionTuning::ResetReport()
+{
+	GReport = FGarbageCollectionReport();
+}
@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Garbage collection timings since the report was last reset
+struct FGarbageCollectionReport
+{
+	// Collections that left the purge to the engine's incremental step, timed from pre to post collect
+	int32 Collections = 0;
+	double TotalMarkMs = 0.0;
+	double MaxMarkMs = 0.0;
+
+	// Collections that purged everything before returning, so their time includes the purge
+	int32 FullPurgeCollections = 0;
+	double MaxFullPurgeCollectMs = 0.0;
+
+	// The engine's incremental purge, read from the GC stat group on frames a purge was pending
+	int32 PurgeFrames = 0;
+	double TotalPurgeMs = 0.0;
+	double MaxPurgeFrameMs = 0.0;
+};
+
+/**
+ * Times collections and the engine's incremental purge for the stats and the soak test. The clustering and
+ * purge settings themselves are in Config/DefaultEngine.ini. Purge times need "stat gc" on, the soak test turns it on.
+ */
+class TOPDOWNSTEALTH_API FGarbageCollectionTuning
+{
+public:
+	static void Startup();
+	static void Shutdown();
+
+	static const FGarbageCollectionReport& GetReport();
+	static void ResetReport();
+};
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GuardAnimSharingStateProcessor.h"
+#include "GuardCharacter.h"
+
+void UGuardAnimSharingStateProcessor::ProcessActorState_Implementation(int32& OutState, AActor* InActor, uint8 CurrentState, uint8 OnDemandState, bool& bShouldProcess)
+{
+	const AGuardCharacter* Guard = Cast<AGuardCharacter>(InActor);
+	if (!Guard)
+	{
+		bShouldProcess = false;
+		return;
+	}
+
+	const float Speed = Guard->GetVelocity().Size2D();
+
+	EGuardAnimState State = EGuardAnimState::Idle;
+	if (Speed > Guard->SprintSpeedThreshold)
+	{
+		State = EGuardAnimState::Sprint;
+	}
+	else if (Speed > 10.0f)
+	{
+		State = EGuardAnimState::PatrolWalk;
+	}
+	else if (Guard->bIsLookingAround)
+	{
+		State = EGuardAnimState::LookAround;
+	}
+
+	OutState = (int32)State;
+	bShouldProcess = true;
+}
+
+UEnum* UGuardAnimSharingStateProcessor::GetAnimationStateEnum_Implementation()
+{
+	return StaticEnum<EGuardAnimState>();
+}
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimationSharingTypes.h"
+#include "GuardAnimSharingStateProcessor.generated.h"
+
+// The states calm guards can share poses in, the animation sharing setup asset maps each one to its animations
+UENUM(BlueprintType)
+enum class EGuardAnimState : uint8
+{
+	Idle,
+	PatrolWalk,
+	LookAround,
+	Sprint
+};
+
+// Tells the animation sharing manager which shared state each guard is in
+UCLASS()
+class TOPDOWNSTEALTH_API UGuardAnimSharingStateProcessor : public UAnimationSharingStateProcessor
+{
+	GENERATED_BODY()
+
+public:
+	virtual void ProcessActorState_Implementation(int32& OutState, AActor* InActor, uint8 CurrentState, uint8 OnDemandState, bool& bShouldProcess) override;
+	virtual UEnum* GetAnimationStateEnum_Implementation() override;
+};
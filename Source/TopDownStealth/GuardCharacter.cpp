@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GuardCharacter.h"
+#include "GuardMovementComponent.h"
+#include "SignificanceComponent.h"
+#include "BodyRegistrySubsystem.h"
+#include "GameplayTrace.h"
+#include "TopDownMemoryTracking.h"
+#include "AnimationSharingManager.h"
+#include "Animation/AnimInstance.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+
+AGuardCharacter::AGuardCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UGuardMovementComponent>(ACharacter::CharacterMovementComponentName))
+{
+	// Level placed guards are only tagged from here on, ACharacter's own components come before this scope opens
+	TOPDOWN_LLM_SCOPE(AI);
+
+	bInCombat = false;
+	bIsDead = false;
+	Health = 100.0f;
+	Faction = EFaction::Guards;
+	bUseAnimationSharing = true;
+	bIsLookingAround = false;
+	SprintSpeedThreshold = 400.0f;
+	bAnimationShared = false;
+
+	// Guards rotate to where they walk, the AI controller doesn't drive rotation
+	bUseControllerRotationPitch = false;
+	bUseControllerRotationYaw = false;
+	bUseControllerRotationRoll = false;
+
+	Significance = CreateDefaultSubobject<USignificanceComponent>(TEXT("Significance"));
+	Significance->SignificanceTag = FName("Guard");
+}
+
+void AGuardCharacter::SpawnDefaultController()
+{
+	// The AI controller and its perception and behaviour tree components count towards the guards' budget
+	TOPDOWN_LLM_SCOPE(AI);
+	Super::SpawnDefaultController();
+}
+
+void AGuardCharacter::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	UFactionSubsystem::SyncControllerTeam(this);
+}
+
+void AGuardCharacter::BeginPlay()
+{
+	TOPDOWN_LLM_SCOPE(AI);
+	Super::BeginPlay();
+
+	if (UFactionSubsystem* Factions = UFactionSubsystem::Get(this))
+	{
+		Factions->RegisterMember(this);
+	}
+
+	IndividualAnimClass = GetMesh()->AnimClass;
+	SetSharedAnimation(bUseAnimationSharing);
+}
+
+void AGuardCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFactionSubsystem* Factions = UFactionSubsystem::Get(this))
+	{
+		Factions->UnregisterMember(this);
+	}
+
+	// Just leave the crowd, building the guard's own AnimBP again would be wasted on the way out
+	if (bAnimationShared)
+	{
+		if (UAnimationSharingManager* Sharing = UAnimationSharingManager::GetAnimationSharingManager(this))
+		{
+			Sharing->UnregisterActor(this);
+		}
+		bAnimationShared = false;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AGuardCharacter::SetInCombat(bool bNewInCombat)
+{
+	if (bInCombat != bNewInCombat)
+	{
+		TRACE_GAMEPLAY_EVENT(AIStateChanged, GetActorLocation(), bNewInCombat ? 1 : 0);
+	}
+
+	bInCombat = bNewInCombat;
+
+	if (UGuardMovementComponent* GuardMovement = GetGuardMovement())
+	{
+		GuardMovement->SetInCombat(bNewInCombat);
+	}
+
+	// Fighting guards get their own full animation evaluation
+	SetSharedAnimation(bUseAnimationSharing && !bNewInCombat && !bIsDead);
+}
+
+UGuardMovementComponent* AGuardCharacter::GetGuardMovement() const
+{
+	return Cast<UGuardMovementComponent>(GetCharacterMovement());
+}
+
+AActor* AGuardCharacter::FindNearestHostile(float Radius)
+{
+	UFactionSubsystem* Factions = UFactionSubsystem::Get(this);
+	return Factions ? Factions->FindNearestHostile(this, Radius) : nullptr;
+}
+
+void AGuardCharacter::SetGenericTeamId(const FGenericTeamId& NewTeamId)
+{
+	Faction = (EFaction)NewTeamId.GetId();
+}
+
+FGenericTeamId AGuardCharacter::GetGenericTeamId() const
+{
+	return FGenericTeamId((uint8)Faction);
+}
+
+void AGuardCharacter::TakeMeleeHit(const FMeleeHit& Hit)
+{
+	if (bIsDead)
+	{
+		return;
+	}
+
+	Health = FMath::Max(Health - Hit.Damage, 0.0f);
+
+	if (Health <= 0.0f)
+	{
+		Die();
+	}
+	else
+	{
+		// Hit reaction montages need the guard's own AnimBP, it shares again when it leaves combat
+		SetSharedAnimation(false);
+		OnMeleeHit(Hit);
+	}
+}
+
+void AGuardCharacter::Die()
+{
+	if (bIsDead)
+	{
+		return;
+	}
+
+	bIsDead = true;
+	SetInCombat(false);
+	SetSharedAnimation(false);
+
+	if (UFactionSubsystem* Factions = UFactionSubsystem::Get(this))
+	{
+		Factions->UnregisterMember(this);
+	}
+
+	if (UBodyRegistrySubsystem* Bodies = UBodyRegistrySubsystem::Get(this))
+	{
+		Bodies->AddBody(this);
+	}
+
+	OnDeath();
+}
+
+void AGuardCharacter::SetSharedAnimation(bool bShared)
+{
+	if (bShared == bAnimationShared)
+	{
+		return;
+	}
+
+	USkeletalMeshComponent* MeshComp = GetMesh();
+	UAnimationSharingManager* Sharing = UAnimationSharingManager::AnimationSharingEnabled() ? UAnimationSharingManager::GetAnimationSharingManager(this) : nullptr;
+	if (!Sharing || !MeshComp->SkeletalMesh)
+	{
+		return;
+	}
+
+	if (bShared)
+	{
+		Sharing->RegisterActorWithSkeletonBP(this, MeshComp->SkeletalMesh->Skeleton);
+	}
+	else
+	{
+		Sharing->UnregisterActor(this);
+		MeshComp->SetAnimInstanceClass(IndividualAnimClass);
+	}
+
+	bAnimationShared = bShared;
+}
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Character.h"
+#include "GenericTeamAgentInterface.h"
+#include "MeleeDamageable.h"
+#include "FactionSubsystem.h"
+#include "GuardCharacter.generated.h"
+
+// Base class for the guard Blueprints, swaps in the cheaper guard movement component
+UCLASS(Blueprintable)
+class TOPDOWNSTEALTH_API AGuardCharacter : public ACharacter, public IGenericTeamAgentInterface, public IMeleeDamageable
+{
+	GENERATED_BODY()
+
+public:
+	AGuardCharacter(const FObjectInitializer& ObjectInitializer);
+
+	// Called by the AI when the guard starts or stops fighting
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	void SetInCombat(bool bNewInCombat);
+
+	// Closest enemy of this guard's faction, what the AI should go after after a team switch
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	AActor* FindNearestHostile(float Radius);
+
+	// Begin IGenericTeamAgentInterface
+	virtual void SetGenericTeamId(const FGenericTeamId& NewTeamId) override;
+	virtual FGenericTeamId GetGenericTeamId() const override;
+	// End IGenericTeamAgentInterface
+
+	// Turned guards fight each other, so guards can be hit too
+	virtual void TakeMeleeHit(const FMeleeHit& Hit) override;
+
+	virtual void SpawnDefaultController() override;
+
+	// Gives the AI controller the guard's faction so perception uses the faction relations
+	virtual void PossessedBy(AController* NewController) override;
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Combat")
+	void OnMeleeHit(const FMeleeHit& Hit);
+
+	// Downs the guard and leaves a body for the other guards to find
+	UFUNCTION(BlueprintCallable, Category = "Combat")
+	void Die();
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Combat")
+	void OnDeath();
+
+	/** Returns GuardMovement subobject **/
+	class UGuardMovementComponent* GetGuardMovement() const;
+
+	/** Returns Significance subobject **/
+	FORCEINLINE class USignificanceComponent* GetSignificance() const { return Significance; }
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat)
+	bool bInCombat;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat)
+	bool bIsDead;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Health)
+	float Health;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Team)
+	EFaction Faction;
+
+	// Calm guards sample the shared crowd poses instead of evaluating their own AnimBP
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animation)
+	bool bUseAnimationSharing;
+
+	// Set by the AI while the guard stands still and looks around
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Animation)
+	bool bIsLookingAround;
+
+	// Faster than this counts as sprinting for the shared animation states
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Animation)
+	float SprintSpeedThreshold;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	// Switches between the shared crowd poses and this guard's own AnimBP
+	void SetSharedAnimation(bool bShared);
+
+	bool bAnimationShared;
+
+	UPROPERTY()
+	TSubclassOf<class UAnimInstance> IndividualAnimClass;
+
+	// Lowers tick and animation rate when the guard is off screen
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Optimization, meta = (AllowPrivateAccess = "true"))
+	class USignificanceComponent* Significance;
+};
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "GuardMovementComponent.h"
+#include "GameFramework/Character.h"
+
+UGuardMovementComponent::UGuardMovementComponent()
+{
+	bUsePatrolMovement = true;
+	bInCombat = false;
+
+	// Guards walk on flat dungeon floors, so projecting onto the navmesh is enough to keep them grounded
+	DefaultLandMovementMode = MOVE_NavWalking;
+	bProjectNavMeshWalking = true;
+	// Nav walking ignores world geometry, the move sweep is what keeps guards out of the player and each other
+	bSweepWhileNavWalking = true;
+	NavMeshProjectionInterval = 0.1f;
+	NavAgentProps.bCanWalk = true;
+
+	bOrientRotationToMovement = true;
+	RotationRate = FRotator(0.f, 540.f, 0.f);
+}
+
+void UGuardMovementComponent::BeginPlay()
+{
+	if (!bUsePatrolMovement)
+	{
+		DefaultLandMovementMode = MOVE_Walking;
+	}
+
+	Super::BeginPlay();
+}
+
+void UGuardMovementComponent::SetInCombat(bool bNewInCombat)
+{
+	if (bInCombat == bNewInCombat)
+	{
+		return;
+	}
+
+	bInCombat = bNewInCombat;
+
+	// Landing picks the default mode, so keep it in sync with what we want right now
+	DefaultLandMovementMode = (bUsePatrolMovement && !bInCombat) ? MOVE_NavWalking : MOVE_Walking;
+
+	if (IsMovingOnGround())
+	{
+		SetMovementMode(DefaultLandMovementMode);
+	}
+}
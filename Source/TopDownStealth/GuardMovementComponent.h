@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GuardMovementComponent.generated.h"
+
+/**
+ * Movement for patrolling guards. While patrolling, guards use nav walking: they slide along the navmesh
+ * and only project onto it every NavMeshProjectionInterval, so there are no per-tick floor sweeps. The engine
+ * starts each guard's projection timer at a random offset, so their projections are spread over frames.
+ * Guards in combat fall back to the full walking simulation.
+ */
+UCLASS()
+class TOPDOWNSTEALTH_API UGuardMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	UGuardMovementComponent();
+
+	// Switches between the cheap patrol movement and full character movement
+	UFUNCTION(BlueprintCallable, Category = "Movement")
+	void SetInCombat(bool bNewInCombat);
+
+	UFUNCTION(BlueprintPure, Category = "Movement")
+	bool IsUsingPatrolMovement() const { return MovementMode == MOVE_NavWalking; }
+
+	// Turn this off to always use full character movement
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Guard Movement")
+	bool bUsePatrolMovement;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	bool bInCombat;
+};
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "MeleeDamageable.generated.h"
+
+// Everything the target needs to know about a melee hit
+USTRUCT(BlueprintType)
+struct FMeleeHit
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = Combat)
+	AActor* Attacker;
+
+	UPROPERTY(BlueprintReadOnly, Category = Combat)
+	float Damage;
+
+	UPROPERTY(BlueprintReadOnly, Category = Combat)
+	FVector ImpactPoint;
+
+	// Which way the weapon was moving when it connected, used to pick the left/right hit reaction
+	UPROPERTY(BlueprintReadOnly, Category = Combat)
+	FVector ImpactDirection;
+
+	FMeleeHit()
+		: Attacker(nullptr)
+		, Damage(0.0f)
+		, ImpactPoint(FVector::ZeroVector)
+		, ImpactDirection(FVector::ZeroVector)
+	{
+	}
+};
+
+UINTERFACE(MinimalAPI)
+class UMeleeDamageable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+// Implemented by anything a guard's weapon can hit
+class TOPDOWNSTEALTH_API IMeleeDamageable
+{
+	GENERATED_BODY()
+
+public:
+	virtual void TakeMeleeHit(const FMeleeHit& Hit) = 0;
+};
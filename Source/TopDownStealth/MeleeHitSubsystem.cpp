@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "MeleeHitSubsystem.h"
+#include "MeleeDamageable.h"
+#include "FactionSubsystem.h"
+#include "TopDownStealth.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Melee Sweeps"), STAT_MeleeSweeps, STATGROUP_TopDownStealth);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Melee Swings"), STAT_ActiveMeleeSwings, STATGROUP_TopDownStealth);
+
+UMeleeHitSubsystem* UMeleeHitSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UMeleeHitSubsystem>() : nullptr;
+}
+
+void UMeleeHitSubsystem::BeginSwing(USkeletalMeshComponent* Mesh, FName BaseSocket, FName TipSocket, float Radius, float Damage)
+{
+	// A montage can restart the window before the old one ended, treat that as a new swing
+	EndSwing(Mesh);
+
+	FMeleeSwing& Swing = ActiveSwings.AddDefaulted_GetRef();
+	Swing.Mesh = Mesh;
+	Swing.BaseSocket = BaseSocket;
+	Swing.TipSocket = TipSocket;
+	Swing.Radius = Radius;
+	Swing.Damage = Damage;
+	Swing.LastBase = Mesh->GetSocketLocation(BaseSocket);
+	Swing.LastTip = Mesh->GetSocketLocation(TipSocket);
+}
+
+void UMeleeHitSubsystem::EndSwing(USkeletalMeshComponent* Mesh)
+{
+	ActiveSwings.RemoveAllSwap([Mesh](const FMeleeSwing& Swing) { return Swing.Mesh == Mesh; });
+
+	if (ActiveSwings.Num() == 0)
+	{
+		ReleaseStaleSlots();
+	}
+}
+
+void UMeleeHitSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MeleeSweeps);
+	SET_DWORD_STAT(STAT_ActiveMeleeSwings, ActiveSwings.Num());
+
+	for (int32 i = ActiveSwings.Num() - 1; i >= 0; i--)
+	{
+		USkeletalMeshComponent* Mesh = ActiveSwings[i].Mesh.Get();
+		if (!Mesh)
+		{
+			ActiveSwings.RemoveAtSwap(i);
+			continue;
+		}
+
+		SweepSwing(Mesh, ActiveSwings[i]);
+	}
+}
+
+bool UMeleeHitSubsystem::IsTickable() const
+{
+	return !HasAnyFlags(RF_ClassDefaultObject) && ActiveSwings.Num() > 0;
+}
+
+TStatId UMeleeHitSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMeleeHitSubsystem, STATGROUP_Tickables);
+}
+
+void UMeleeHitSubsystem::SweepSwing(USkeletalMeshComponent* Mesh, FMeleeSwing& Swing)
+{
+	const FVector Base = Mesh->GetSocketLocation(Swing.BaseSocket);
+	const FVector Tip = Mesh->GetSocketLocation(Swing.TipSocket);
+
+	// Capsule lying along the weapon, swept from where the weapon was to where it is now
+	const FVector Blade = Tip - Base;
+	const FQuat Rotation = FRotationMatrix::MakeFromZ(Blade).ToQuat();
+	const FCollisionShape Capsule = FCollisionShape::MakeCapsule(Swing.Radius, Blade.Size() * 0.5f + Swing.Radius);
+	const FVector From = (Swing.LastBase + Swing.LastTip) * 0.5f;
+	const FVector To = (Base + Tip) * 0.5f;
+
+	Swing.LastBase = Base;
+	Swing.LastTip = Tip;
+
+	AActor* Attacker = Mesh->GetOwner();
+	UFactionSubsystem* Factions = UFactionSubsystem::Get(Mesh);
+	const IGenericTeamAgentInterface* AttackerTeam = Cast<IGenericTeamAgentInterface>(Attacker);
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MeleeSwing), false, Attacker);
+
+	TArray<FHitResult> Hits;
+	Mesh->GetWorld()->SweepMultiByObjectType(Hits, From, To, Rotation, FCollisionObjectQueryParams(ECC_Pawn), Capsule, QueryParams);
+
+	for (const FHitResult& Hit : Hits)
+	{
+		AActor* HitActor = Hit.GetActor();
+		IMeleeDamageable* Target = Cast<IMeleeDamageable>(HitActor);
+		if (!Target)
+		{
+			continue;
+		}
+
+		// Guards only hurt whoever their faction is hostile to
+		const IGenericTeamAgentInterface* TargetTeam = Cast<IGenericTeamAgentInterface>(HitActor);
+		if (Factions && AttackerTeam && TargetTeam && !Factions->IsHostile(AttackerTeam->GetGenericTeamId().GetId(), TargetTeam->GetGenericTeamId().GetId()))
+		{
+			continue;
+		}
+
+		const int32 Slot = GetTargetSlot(HitActor);
+		while (Swing.HitMask.Num() <= Slot)
+		{
+			Swing.HitMask.Add(false);
+		}
+
+		// Each target only takes one hit per swing, no matter how many frames the weapon stays in it
+		if (Swing.HitMask[Slot])
+		{
+			continue;
+		}
+		Swing.HitMask[Slot] = true;
+
+		FMeleeHit MeleeHit;
+		MeleeHit.Attacker = Attacker;
+		MeleeHit.Damage = Swing.Damage;
+		MeleeHit.ImpactPoint = Hit.ImpactPoint;
+		MeleeHit.ImpactDirection = (To - From).GetSafeNormal();
+		Target->TakeMeleeHit(MeleeHit);
+	}
+}
+
+int32 UMeleeHitSubsystem::GetTargetSlot(AActor* Target)
+{
+	if (const int32* Slot = TargetSlots.Find(Target))
+	{
+		return *Slot;
+	}
+
+	const int32 NewSlot = FreeSlots.Num() > 0 ? FreeSlots.Pop(false) : TargetSlots.Num();
+	TargetSlots.Add(Target, NewSlot);
+	return NewSlot;
+}
+
+void UMeleeHitSubsystem::ReleaseStaleSlots()
+{
+	for (auto It = TargetSlots.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid())
+		{
+			FreeSlots.Add(It.Value());
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "MeleeHitSubsystem.generated.h"
+
+class USkeletalMeshComponent;
+
+// A weapon swing that is currently inside its melee notify window
+struct FMeleeSwing
+{
+	TWeakObjectPtr<USkeletalMeshComponent> Mesh;
+
+	FName BaseSocket;
+	FName TipSocket;
+	float Radius;
+	float Damage;
+
+	// Where the weapon was on the previous sweep, so fast swings don't skip through targets
+	FVector LastBase;
+	FVector LastTip;
+
+	// One bit per target slot, set when that target has already been hit by this swing
+	TBitArray<> HitMask;
+};
+
+/**
+ * Collects the active melee swings and runs all their capsule sweeps together once per frame,
+ * after the animations have been updated. Hits go to IMeleeDamageable.
+ */
+UCLASS()
+class TOPDOWNSTEALTH_API UMeleeHitSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UMeleeHitSubsystem* Get(const UObject* WorldContextObject);
+
+	void BeginSwing(USkeletalMeshComponent* Mesh, FName BaseSocket, FName TipSocket, float Radius, float Damage);
+
+	void EndSwing(USkeletalMeshComponent* Mesh);
+
+	// Begin FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject interface
+
+private:
+	void SweepSwing(USkeletalMeshComponent* Mesh, FMeleeSwing& Swing);
+
+	// Gives each damageable actor a small index into the swing hit masks
+	int32 GetTargetSlot(AActor* Target);
+
+	void ReleaseStaleSlots();
+
+	TArray<FMeleeSwing> ActiveSwings;
+
+	TMap<TWeakObjectPtr<AActor>, int32> TargetSlots;
+
+	TArray<int32> FreeSlots;
+};
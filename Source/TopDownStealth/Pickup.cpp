@@ -3,13 +3,24 @@
 #include "Pickup.h"
 #include "Components/SphereComponent.h"
 #include "TopDownStealthCharacter.h"
+#include "SignificanceComponent.h"
+#include "GameplayTrace.h"
+#include "TopDownMemoryTracking.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
 
 // Sets default values
 APickup::APickup()
 {
+	// Covers the components made below, level placed pickups only ever go through here
+	TOPDOWN_LLM_SCOPE(Pickups);
+
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = false;
 
+	// Pickups placed in the level are marked with the level's GC cluster instead of one by one
+	bCanBeInCluster = true;
+
 	CollisionComp = CreateDefaultSubobject<USphereComponent>(TEXT("CollisionSphere"));
 	CollisionComp->InitSphereRadius(50.0f);
 	CollisionComp->BodyInstance.SetCollisionProfileName("OverlapAllDynamic");
@@ -17,6 +28,25 @@ APickup::APickup()
 	CollisionComp->OnComponentBeginOverlap.AddDynamic(this, &APickup::OnOverlap);
 	CollisionComp->OnComponentEndOverlap.AddDynamic(this, &APickup::EndOverlap);
 
+	Significance = CreateDefaultSubobject<USignificanceComponent>(TEXT("Significance"));
+	Significance->SignificanceTag = FName("Pickup");
+
+}
+
+APickup* APickup::SpawnPickup(UObject* WorldContextObject, TSubclassOf<APickup> PickupClass, const FTransform& Transform)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World || !PickupClass)
+	{
+		return nullptr;
+	}
+
+	// Also counts the actor itself and whatever spawning allocates outside the constructor
+	TOPDOWN_LLM_SCOPE(Pickups);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	return World->SpawnActor<APickup>(PickupClass, Transform, SpawnParams);
 }
 
 // Called when the game starts or when spawned
@@ -37,11 +67,9 @@ void APickup::OnOverlap(UPrimitiveComponent* OverlappedComp, AActor* OtherActor,
 {
 	ATopDownStealthCharacter* Player = Cast<ATopDownStealthCharacter>(OtherActor);
 
-	UE_LOG(LogTemp, Warning, TEXT("Large F"));
-
 	if (Player)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Large Cast"));
+		TRACE_GAMEPLAY_EVENT(PickupCollected, GetActorLocation(), 0);
 		Player->UpdatePickup(this);
 	}
 }
@@ -15,6 +15,10 @@ public:
 	// Sets default values for this actor's properties
 	APickup();
 
+	// Spawns a pickup at runtime (drops, rewards), counted towards the Pickups memory budget
+	UFUNCTION(BlueprintCallable, Category = "Pickup", meta = (WorldContext = "WorldContextObject"))
+	static APickup* SpawnPickup(UObject* WorldContextObject, TSubclassOf<APickup> PickupClass, const FTransform& Transform);
+
 	UFUNCTION()
 	void OnOverlap (UPrimitiveComponent* OverlappedComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 
@@ -63,4 +67,8 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Collision, meta = (AllowPrivateAccess = "true"))
 	class USphereComponent* CollisionComp;
 
+	// Turns off ticking when the pickup is off screen
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Optimization, meta = (AllowPrivateAccess = "true"))
+	class USignificanceComponent* Significance;
+
 };
@@ -0,0 +1,281 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SignificanceComponent.h"
+#include "TopDownStealth.h"
+#include "GuardCharacter.h"
+#include "SignificanceManager.h"
+#include "AIController.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+USignificanceComponent::USignificanceComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	FootprintRadius = 1400.0f;
+	NearDistance = 1500.0f;
+	NearTickInterval = 0.1f;
+	FarTickInterval = 0.5f;
+	SignificanceTag = FName("Actor");
+	bCullingEnabled = true;
+
+	Bucket = ESignificanceBucket::Critical;
+	bOwnerTickWasEnabled = false;
+}
+
+void USignificanceComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	bOwnerTickWasEnabled = GetOwner()->IsActorTickEnabled();
+
+	if (!bCullingEnabled)
+	{
+		return;
+	}
+
+	if (USignificanceManager* Significance = USignificanceManager::Get(GetWorld()))
+	{
+		auto SignificanceFunction = [this](USignificanceManager::FManagedObjectInfo* ObjectInfo, const FTransform& Viewpoint)
+		{
+			return CalculateSignificance(Viewpoint);
+		};
+
+		auto PostSignificanceFunction = [this](USignificanceManager::FManagedObjectInfo* ObjectInfo, float OldSignificance, float NewSignificance, bool bFinal)
+		{
+			ApplyBucket(BucketFromSignificance(NewSignificance));
+		};
+
+		Significance->RegisterObject(GetOwner(), SignificanceTag, SignificanceFunction, USignificanceManager::EPostSignificanceType::Sequential, PostSignificanceFunction);
+	}
+}
+
+void USignificanceComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	USignificanceManager* Significance = bCullingEnabled ? USignificanceManager::Get(GetWorld()) : nullptr;
+	if (Significance)
+	{
+		Significance->UnregisterObject(GetOwner());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+float USignificanceComponent::CalculateSignificance(const FTransform& Viewpoint) const
+{
+	if (IsOwnerRelevant())
+	{
+		return 2.0f;
+	}
+
+	const FVector Location = GetOwner()->GetActorLocation();
+
+	// The camera looks down at an angle, so the visible ground is centered where its view ray meets the owner's height
+	FVector FootprintCenter = Viewpoint.GetLocation();
+	const FVector ViewDirection = Viewpoint.GetRotation().GetForwardVector();
+	if (ViewDirection.Z < -KINDA_SMALL_NUMBER)
+	{
+		FootprintCenter += ViewDirection * ((Location.Z - FootprintCenter.Z) / ViewDirection.Z);
+	}
+
+	const float DistanceOutside = FMath::Max(FVector::Dist2D(Location, FootprintCenter) - FootprintRadius, 0.0f);
+	const float Visibility = 1.0f / (1.0f + DistanceOutside / NearDistance);
+
+	// Out of view and not doing anything, safe to stop ticking entirely
+	if (DistanceOutside > 0.0f && !IsOwnerActive())
+	{
+		return 0.0f;
+	}
+
+	return Visibility;
+}
+
+ESignificanceBucket USignificanceComponent::BucketFromSignificance(float Significance)
+{
+	if (Significance >= 1.0f)
+	{
+		return ESignificanceBucket::Critical;
+	}
+	else if (Significance >= 0.5f)
+	{
+		return ESignificanceBucket::Near;
+	}
+	else if (Significance > 0.0f)
+	{
+		return ESignificanceBucket::Far;
+	}
+	return ESignificanceBucket::Dormant;
+}
+
+bool USignificanceComponent::IsOwnerActive() const
+{
+	AActor* Owner = GetOwner();
+	if (Owner->GetVelocity().SizeSquared() > 100.0f)
+	{
+		return true;
+	}
+
+	// A guard that was just told to walk hasn't started moving yet, but still needs its movement to tick
+	if (APawn* Pawn = Cast<APawn>(Owner))
+	{
+		if (AAIController* AI = Cast<AAIController>(Pawn->GetController()))
+		{
+			return AI->GetMoveStatus() != EPathFollowingStatus::Idle;
+		}
+	}
+
+	return false;
+}
+
+bool USignificanceComponent::IsOwnerRelevant() const
+{
+	AGuardCharacter* Guard = Cast<AGuardCharacter>(GetOwner());
+	return Guard && Guard->bInCombat;
+}
+
+void USignificanceComponent::ApplyBucket(ESignificanceBucket NewBucket)
+{
+	if (NewBucket == Bucket)
+	{
+		return;
+	}
+
+	AActor* Owner = GetOwner();
+
+	// Wake everything we put to sleep before going to a ticking bucket
+	if (Bucket == ESignificanceBucket::Dormant)
+	{
+		for (UActorComponent* Component : DormantComponents)
+		{
+			if (Component)
+			{
+				Component->SetComponentTickEnabled(true);
+			}
+		}
+		DormantComponents.Reset();
+		Owner->SetActorTickEnabled(bOwnerTickWasEnabled);
+	}
+
+	Bucket = NewBucket;
+
+	if (Bucket == ESignificanceBucket::Dormant)
+	{
+		bOwnerTickWasEnabled = Owner->IsActorTickEnabled();
+		Owner->SetActorTickEnabled(false);
+
+		for (UActorComponent* Component : Owner->GetComponents())
+		{
+			if (Component && Component != this && Component->IsComponentTickEnabled())
+			{
+				Component->SetComponentTickEnabled(false);
+				DormantComponents.Add(Component);
+			}
+		}
+		return;
+	}
+
+	float TickInterval = 0.0f;
+	if (Bucket == ESignificanceBucket::Near)
+	{
+		TickInterval = NearTickInterval;
+	}
+	else if (Bucket == ESignificanceBucket::Far)
+	{
+		TickInterval = FarTickInterval;
+	}
+
+	Owner->SetActorTickInterval(TickInterval);
+
+	TInlineComponentArray<USkeletalMeshComponent*> Meshes(Owner);
+	for (USkeletalMeshComponent* Mesh : Meshes)
+	{
+		// Let the mesh skip animation frames when it's off screen
+		Mesh->bEnableUpdateRateOptimizations = (Bucket != ESignificanceBucket::Critical);
+		Mesh->SetComponentTickInterval(TickInterval);
+	}
+}
+
+float USignificanceComponent::GetTicksPerSecond(float FrameRate) const
+{
+	auto Rate = [FrameRate](float Interval)
+	{
+		return Interval > 0.0f ? FMath::Min(1.0f / Interval, FrameRate) : FrameRate;
+	};
+
+	AActor* Owner = GetOwner();
+	float TicksPerSecond = Owner->IsActorTickEnabled() ? Rate(Owner->GetActorTickInterval()) : 0.0f;
+
+	for (UActorComponent* Component : Owner->GetComponents())
+	{
+		if (Component && Component->IsComponentTickEnabled())
+		{
+			TicksPerSecond += Rate(Component->GetComponentTickInterval());
+		}
+	}
+	return TicksPerSecond;
+}
+
+int32 USignificanceComponent::GetAnimatedMeshCount() const
+{
+	int32 Count = 0;
+
+	TInlineComponentArray<USkeletalMeshComponent*> Meshes(GetOwner());
+	for (USkeletalMeshComponent* Mesh : Meshes)
+	{
+		if (Mesh->IsComponentTickEnabled() && Mesh->SkeletalMesh)
+		{
+			Count++;
+		}
+	}
+	return Count;
+}
+
+// Prints how many actors are in each bucket and roughly what they cost
+static void DumpSignificanceBuckets(UWorld* World)
+{
+	USignificanceManager* Significance = USignificanceManager::Get(World);
+	if (!Significance)
+	{
+		UE_LOG(LogTopDownStealth, Display, TEXT("No significance manager in this world"));
+		return;
+	}
+
+	const float FrameRate = FApp::GetDeltaTime() > 0.0 ? (float)(1.0 / FApp::GetDeltaTime()) : 60.0f;
+
+	int32 Actors[(int32)ESignificanceBucket::Count] = {};
+	float TicksPerSecond[(int32)ESignificanceBucket::Count] = {};
+	int32 AnimatedMeshes[(int32)ESignificanceBucket::Count] = {};
+
+	TArray<const USignificanceManager::FManagedObjectInfo*> Objects;
+	Significance->GetManagedObjects(Objects);
+
+	for (const USignificanceManager::FManagedObjectInfo* Info : Objects)
+	{
+		AActor* Actor = Cast<AActor>(Info->GetObject());
+		USignificanceComponent* Component = Actor ? Actor->FindComponentByClass<USignificanceComponent>() : nullptr;
+		if (!Component)
+		{
+			continue;
+		}
+
+		const int32 Index = (int32)Component->GetBucket();
+		Actors[Index]++;
+		TicksPerSecond[Index] += Component->GetTicksPerSecond(FrameRate);
+		AnimatedMeshes[Index] += Component->GetAnimatedMeshCount();
+	}
+
+	const UEnum* BucketEnum = StaticEnum<ESignificanceBucket>();
+	UE_LOG(LogTopDownStealth, Display, TEXT("Significance buckets (%d objects, %.0f fps):"), Objects.Num(), FrameRate);
+	for (int32 i = 0; i < (int32)ESignificanceBucket::Count; i++)
+	{
+		UE_LOG(LogTopDownStealth, Display, TEXT("  %-10s actors: %4d  ticks/s: %8.1f  animated meshes: %4d"),
+			*BucketEnum->GetNameStringByIndex(i), Actors[i], TicksPerSecond[i], AnimatedMeshes[i]);
+	}
+}
+
+static FAutoConsoleCommandWithWorld DumpSignificanceCommand(
+	TEXT("TopDown.Significance.Dump"),
+	TEXT("Prints the significance buckets with actor count, ticks per second and animated meshes per bucket"),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&DumpSignificanceBuckets));
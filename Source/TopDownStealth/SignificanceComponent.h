@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "SignificanceComponent.generated.h"
+
+UENUM(BlueprintType)
+enum class ESignificanceBucket : uint8
+{
+	// On screen or in the middle of something (combat), full rate
+	Critical,
+	// Just outside the camera footprint
+	Near,
+	// Far outside the camera footprint but still doing something
+	Far,
+	// Out of view and idle, no ticking at all
+	Dormant,
+
+	Count UMETA(Hidden)
+};
+
+/**
+ * Registers the owner with the significance manager. The owner is scored by how far it is from
+ * the ground area the top down camera can see and by whether it's doing anything, and its tick rate
+ * and animation update rate are lowered to match.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class TOPDOWNSTEALTH_API USignificanceComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	USignificanceComponent();
+
+	UFUNCTION(BlueprintPure, Category = "Significance")
+	ESignificanceBucket GetBucket() const { return Bucket; }
+
+	// Estimated ticks per second of the owner and its components in the current bucket
+	float GetTicksPerSecond(float FrameRate) const;
+
+	// Number of skeletal meshes on the owner that still update their animation
+	int32 GetAnimatedMeshCount() const;
+
+	// Radius of the ground area the camera sees, around the point it looks at
+	UPROPERTY(EditDefaultsOnly, Category = "Significance")
+	float FootprintRadius;
+
+	// Anything closer than this to the footprint edge counts as near
+	UPROPERTY(EditDefaultsOnly, Category = "Significance")
+	float NearDistance;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Significance")
+	float NearTickInterval;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Significance")
+	float FarTickInterval;
+
+	// Turn off to keep the owner at full rate wherever it is, read when play begins (used by the animation benchmark)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Significance")
+	bool bCullingEnabled;
+
+	// Tag the owner is registered with in the significance manager
+	UPROPERTY(EditDefaultsOnly, Category = "Significance")
+	FName SignificanceTag;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	float CalculateSignificance(const FTransform& Viewpoint) const;
+
+	void ApplyBucket(ESignificanceBucket NewBucket);
+
+	// Moving, following a path or in combat
+	bool IsOwnerActive() const;
+
+	bool IsOwnerRelevant() const;
+
+	static ESignificanceBucket BucketFromSignificance(float Significance);
+
+	ESignificanceBucket Bucket;
+
+	// Components we turned off when going dormant, so we only turn those back on
+	UPROPERTY()
+	TArray<UActorComponent*> DormantComponents;
+
+	bool bOwnerTickWasEnabled;
+};
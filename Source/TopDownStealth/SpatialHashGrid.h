@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Buckets elements into square cells on the XY plane so "what's near here" only looks at a few cells.
+ * The grid only knows which cell each element is in, callers check exact distances themselves.
+ */
+template<typename ElementType>
+class TSpatialHashGrid
+{
+public:
+	explicit TSpatialHashGrid(float InCellSize = 500.0f)
+		: CellSize(InCellSize)
+	{
+	}
+
+	// Adds the element, or moves it if it's already in the grid
+	void Update(const ElementType& Element, const FVector& Location)
+	{
+		const FIntPoint NewCell = CellFor(Location);
+
+		if (FIntPoint* OldCell = ElementCells.Find(Element))
+		{
+			if (*OldCell == NewCell)
+			{
+				return;
+			}
+			RemoveFromCell(Element, *OldCell);
+			*OldCell = NewCell;
+		}
+		else
+		{
+			ElementCells.Add(Element, NewCell);
+		}
+
+		Cells.FindOrAdd(NewCell).Add(Element);
+	}
+
+	void Remove(const ElementType& Element)
+	{
+		FIntPoint Cell;
+		if (ElementCells.RemoveAndCopyValue(Element, Cell))
+		{
+			RemoveFromCell(Element, Cell);
+		}
+	}
+
+	bool Contains(const ElementType& Element) const
+	{
+		return ElementCells.Contains(Element);
+	}
+
+	int32 Num() const
+	{
+		return ElementCells.Num();
+	}
+
+	void Reset()
+	{
+		Cells.Reset();
+		ElementCells.Reset();
+	}
+
+	// Calls Visitor on every element in a cell that overlaps the circle
+	template<typename FunctorType>
+	void ForEachInRadius(const FVector& Center, float Radius, FunctorType&& Visitor) const
+	{
+		const FIntPoint Min = CellFor(Center - FVector(Radius, Radius, 0.0f));
+		const FIntPoint Max = CellFor(Center + FVector(Radius, Radius, 0.0f));
+
+		for (int32 X = Min.X; X <= Max.X; X++)
+		{
+			for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+			{
+				if (const TArray<ElementType>* Cell = Cells.Find(FIntPoint(X, Y)))
+				{
+					for (const ElementType& Element : *Cell)
+					{
+						Visitor(Element);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	FIntPoint CellFor(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize));
+	}
+
+	void RemoveFromCell(const ElementType& Element, const FIntPoint& Cell)
+	{
+		if (TArray<ElementType>* Elements = Cells.Find(Cell))
+		{
+			Elements->RemoveSingleSwap(Element, false);
+			if (Elements->Num() == 0)
+			{
+				Cells.Remove(Cell);
+			}
+		}
+	}
+
+	float CellSize;
+
+	TMap<FIntPoint, TArray<ElementType>> Cells;
+
+	TMap<ElementType, FIntPoint> ElementCells;
+};
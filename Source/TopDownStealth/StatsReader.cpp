@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "StatsReader.h"
+#include "Stats/StatsData.h"
+
+double FStatsReader::GetLatestMs(FName StatName)
+{
+#if STATS
+	const FGameThreadStatsData* Stats = FLatestGameThreadStatsData::Get().Latest;
+	if (!Stats)
+	{
+		return 0.0;
+	}
+
+	for (const FActiveStatGroupInfo& Group : Stats->ActiveStatGroups)
+	{
+		for (const FComplexStatMessage& Message : Group.FlatAggregate)
+		{
+			if (Message.GetShortName() == StatName)
+			{
+				return FPlatformTime::ToMilliseconds(Message.GetValue_Duration(EComplexStatField::IncAve));
+			}
+		}
+	}
+#endif
+	return 0.0;
+}
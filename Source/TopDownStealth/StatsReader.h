@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Reads cycle stats back out of the stats system, for benchmarks and soak reports that log them
+class TOPDOWNSTEALTH_API FStatsReader
+{
+public:
+	/**
+	 * Average time of a cycle stat (by its short name, e.g. STAT_PerformAnimEvaluation) in the latest stats data,
+	 * summed over every thread it ran on. Its group has to be turned on with "stat <group>", 0 in builds without stats.
+	 */
+	static double GetLatestMs(FName StatName);
+};
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "StealthLightingLibrary.h"
+#include "Engine/PointLight.h"
+#include "Engine/World.h"
+#include "Components/PointLightComponent.h"
+
+bool UStealthLightingLibrary::IsLocationInLight(const UObject* WorldContextObject, const FVector& Location, const TArray<AActor*>& PointLights, AActor* IgnoredActor)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!World)
+	{
+		return false;
+	}
+
+	FCollisionQueryParams collisionParams;
+	if (IgnoredActor)
+	{
+		collisionParams.AddIgnoredActor(IgnoredActor);
+	}
+
+	//Iterate through all lights in the scene
+	for (AActor* lightActor : PointLights)
+	{
+		//Make sure it's a point light and it exists
+		if (IsLitBy(World, Location, Cast<APointLight>(lightActor), collisionParams))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UStealthLightingLibrary::IsLocationInLight(const UObject* WorldContextObject, const FVector& Location, const TArray<TWeakObjectPtr<APointLight>>& PointLights, AActor* IgnoredActor)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!World)
+	{
+		return false;
+	}
+
+	FCollisionQueryParams collisionParams;
+	if (IgnoredActor)
+	{
+		collisionParams.AddIgnoredActor(IgnoredActor);
+	}
+
+	for (const TWeakObjectPtr<APointLight>& light : PointLights)
+	{
+		if (IsLitBy(World, Location, light.Get(), collisionParams))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UStealthLightingLibrary::IsLitBy(UWorld* World, const FVector& Location, const APointLight* Light, const FCollisionQueryParams& Params)
+{
+	if (!Light)
+	{
+		return false;
+	}
+
+	//If the location is within the attenuation of the light (the light reaches it)
+	const float distance = (Light->GetActorLocation() - Location).Size();
+	if (distance >= Light->PointLightComponent->AttenuationRadius)
+	{
+		return false;
+	}
+
+	//Do a line trace from the location to the light to make sure it isn't behind anything, and if it isn't, then it's in the light
+	FHitResult hitResult;
+	return !World->LineTraceSingleByChannel(hitResult, Location, Light->GetActorLocation(), ECC_Visibility, Params);
+}
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "StealthLightingLibrary.generated.h"
+
+struct FCollisionQueryParams;
+
+// Light exposure checks shared by the player's light meter and the guards' perception
+UCLASS()
+class TOPDOWNSTEALTH_API UStealthLightingLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	// True if any of the point lights reaches the location without being blocked
+	UFUNCTION(BlueprintCallable, Category = "Stealth", meta = (WorldContext = "WorldContextObject"))
+	static bool IsLocationInLight(const UObject* WorldContextObject, const FVector& Location, const TArray<AActor*>& PointLights, AActor* IgnoredActor);
+
+	// Same check against a weak light cache, lights that have been destroyed are skipped
+	static bool IsLocationInLight(const UObject* WorldContextObject, const FVector& Location, const TArray<TWeakObjectPtr<class APointLight>>& PointLights, AActor* IgnoredActor);
+
+private:
+	static bool IsLitBy(UWorld* World, const FVector& Location, const class APointLight* Light, const FCollisionQueryParams& Params);
+};
@@ -0,0 +1,9 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "StealthPointLight.h"
+
+AStealthPointLight::AStealthPointLight(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bCanBeInCluster = true;
+}
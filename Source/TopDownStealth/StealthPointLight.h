@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/PointLight.h"
+#include "StealthPointLight.generated.h"
+
+// Point light that is grouped into its level's GC cluster, use it for the level's static lights
+UCLASS()
+class TOPDOWNSTEALTH_API AStealthPointLight : public APointLight
+{
+	GENERATED_BODY()
+
+public:
+	AStealthPointLight(const FObjectInitializer& ObjectInitializer);
+};
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TopDownMemoryTracking.h"
+#include "TopDownStealth.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/LowLevelMemStats.h"
+#include "Containers/Ticker.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+DECLARE_LLM_MEMORY_STAT(TEXT("Arrows"), STAT_ArrowsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Pickups"), STAT_PickupsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Lights"), STAT_LightsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("AI"), STAT_AILLM, STATGROUP_LLMFULL);
+
+static TAutoConsoleVariable<float> CVarArrowsBudget(TEXT("TopDown.LLM.Budget.Arrows"), 32.0f, TEXT("Memory budget for arrows in MB (0 = no budget)"));
+static TAutoConsoleVariable<float> CVarPickupsBudget(TEXT("TopDown.LLM.Budget.Pickups"), 16.0f, TEXT("Memory budget for pickups in MB (0 = no budget)"));
+static TAutoConsoleVariable<float> CVarLightsBudget(TEXT("TopDown.LLM.Budget.Lights"), 4.0f, TEXT("Memory budget for the light caches in MB (0 = no budget)"));
+static TAutoConsoleVariable<float> CVarAIBudget(TEXT("TopDown.LLM.Budget.AI"), 64.0f, TEXT("Memory budget for guards and their AI controllers in MB (0 = no budget)"));
+
+struct FTopDownLLMTagInfo
+{
+	ETopDownLLMTag Tag;
+	const TCHAR* Name;
+	FName StatName;
+	TAutoConsoleVariable<float>* Budget;
+	// Only report once each time the tag goes over
+	bool bOverBudget;
+};
+
+static FTopDownLLMTagInfo GTopDownLLMTags[] =
+{
+	{ ETopDownLLMTag::Arrows, TEXT("Arrows"), GET_STATFNAME(STAT_ArrowsLLM), &CVarArrowsBudget, false },
+	{ ETopDownLLMTag::Pickups, TEXT("Pickups"), GET_STATFNAME(STAT_PickupsLLM), &CVarPickupsBudget, false },
+	{ ETopDownLLMTag::Lights, TEXT("Lights"), GET_STATFNAME(STAT_LightsLLM), &CVarLightsBudget, false },
+	{ ETopDownLLMTag::AI, TEXT("AI"), GET_STATFNAME(STAT_AILLM), &CVarAIBudget, false },
+};
+
+static FDelegateHandle GBudgetTickerHandle;
+
+static double GetTagMB(const FTopDownLLMTagInfo& Info)
+{
+	return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, (ELLMTag)Info.Tag) / (1024.0 * 1024.0);
+}
+
+static bool CheckMemoryBudgets(float DeltaTime)
+{
+	for (FTopDownLLMTagInfo& Info : GTopDownLLMTags)
+	{
+		const float BudgetMB = Info.Budget->GetValueOnGameThread();
+		const double UsedMB = GetTagMB(Info);
+		const bool bOverBudget = BudgetMB > 0.0f && UsedMB > BudgetMB;
+
+		if (bOverBudget && !Info.bOverBudget)
+		{
+			// Automation tests fail on logged errors, so running over budget fails the test
+			if (GIsAutomationTesting)
+			{
+				UE_LOG(LogTopDownStealth, Error, TEXT("LLM tag %s is over budget: %.2f MB used, %.2f MB budget"), Info.Name, UsedMB, BudgetMB);
+			}
+			else
+			{
+				UE_LOG(LogTopDownStealth, Warning, TEXT("LLM tag %s is over budget: %.2f MB used, %.2f MB budget"), Info.Name, UsedMB, BudgetMB);
+			}
+		}
+		Info.bOverBudget = bOverBudget;
+	}
+	return true;
+}
+
+static void DumpMemoryTags()
+{
+	if (!FLowLevelMemTracker::IsEnabled())
+	{
+		UE_LOG(LogTopDownStealth, Display, TEXT("LLM is off, run with -LLM to track memory per tag"));
+		return;
+	}
+
+	UE_LOG(LogTopDownStealth, Display, TEXT("LLM tags:"));
+	for (const FTopDownLLMTagInfo& Info : GTopDownLLMTags)
+	{
+		const float BudgetMB = Info.Budget->GetValueOnGameThread();
+		const double UsedMB = GetTagMB(Info);
+
+		if (BudgetMB > 0.0f)
+		{
+			UE_LOG(LogTopDownStealth, Display, TEXT("  %-16s %9.2f MB / %9.2f MB (%3.0f%%)"), Info.Name, UsedMB, BudgetMB, UsedMB * 100.0 / BudgetMB);
+		}
+		else
+		{
+			UE_LOG(LogTopDownStealth, Display, TEXT("  %-16s %9.2f MB (no budget)"), Info.Name, UsedMB);
+		}
+	}
+}
+
+static FAutoConsoleCommand DumpMemoryTagsCommand(
+	TEXT("TopDown.LLM.Dump"),
+	TEXT("Prints the memory used by each TopDownStealth LLM tag against its budget"),
+	FConsoleCommandDelegate::CreateStatic(&DumpMemoryTags));
+
+void FTopDownMemoryTracking::Startup()
+{
+	static_assert((int32)ETopDownLLMTag::End <= (int32)ELLMTag::ProjectTagEnd, "Too many project LLM tags");
+
+	if (!FLowLevelMemTracker::IsEnabled())
+	{
+		return;
+	}
+
+	for (const FTopDownLLMTagInfo& Info : GTopDownLLMTags)
+	{
+		FLowLevelMemTracker::Get().RegisterProjectTag((int32)Info.Tag, Info.Name, Info.StatName, NAME_None);
+	}
+
+	GBudgetTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&CheckMemoryBudgets), 1.0f);
+}
+
+void FTopDownMemoryTracking::Shutdown()
+{
+	if (GBudgetTickerHandle.IsValid())
+	{
+		FTicker::GetCoreTicker().RemoveTicker(GBudgetTickerHandle);
+		GBudgetTickerHandle.Reset();
+	}
+}
+
+#else
+
+void FTopDownMemoryTracking::Startup()
+{
+}
+
+void FTopDownMemoryTracking::Shutdown()
+{
+}
+
+#endif
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+
+// Low Level Memory Tracker tags for the game's own systems, run with -LLM to track them
+enum class ETopDownLLMTag : LLM_TAG_TYPE
+{
+	Arrows = (LLM_TAG_TYPE)ELLMTag::ProjectTagStart,
+	Pickups,
+	Lights,
+	AI,
+
+	End
+};
+
+#define TOPDOWN_LLM_SCOPE(Tag) LLM_SCOPE((ELLMTag)ETopDownLLMTag::Tag)
+
+#else
+
+#define TOPDOWN_LLM_SCOPE(Tag)
+
+#endif
+
+/**
+ * Registers the tags and checks each one against its budget (TopDown.LLM.Budget.<Tag>, in MB) once a second.
+ * Going over budget is a warning, or an error while automation tests run so the test fails.
+ */
+class TOPDOWNSTEALTH_API FTopDownMemoryTracking
+{
+public:
+	static void Startup();
+	static void Shutdown();
+};
@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TopDownRecastNavMesh.h"
+
+ATopDownRecastNavMesh::ATopDownRecastNavMesh(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	// Runtime obstacles only swap nav modifiers, the level geometry stays as baked
+	RuntimeGeneration = ERuntimeGenerationType::DynamicModifiersOnly;
+}
+
+void ATopDownRecastNavMesh::OnNavMeshTilesUpdated(const TArray<uint32>& ChangedTiles)
+{
+	Super::OnNavMeshTilesUpdated(ChangedTiles);
+
+	OnTilesRebuilt.Broadcast(this, ChangedTiles);
+}
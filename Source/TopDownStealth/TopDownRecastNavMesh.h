@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "TopDownRecastNavMesh.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnNavTilesRebuilt, class ATopDownRecastNavMesh*, const TArray<uint32>&);
+
+/**
+ * Recast navmesh that tells listeners which tiles the generator just rebuilt, so runtime obstacles can
+ * tell their own rebuild apart from everyone else's. Set as the agent's NavDataClass in DefaultEngine.ini.
+ */
+UCLASS()
+class TOPDOWNSTEALTH_API ATopDownRecastNavMesh : public ARecastNavMesh
+{
+	GENERATED_BODY()
+
+public:
+	ATopDownRecastNavMesh(const FObjectInitializer& ObjectInitializer);
+
+	virtual void OnNavMeshTilesUpdated(const TArray<uint32>& ChangedTiles) override;
+
+	// Tile indices match the ones GetNavMeshTilesIn returns
+	FOnNavTilesRebuilt OnTilesRebuilt;
+};
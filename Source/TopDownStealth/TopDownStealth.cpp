@@ -2,8 +2,28 @@
 
 #include "TopDownStealth.h"
 #include "Modules/ModuleManager.h"
+#include "GameplayTrace.h"
+#include "TopDownMemoryTracking.h"
+#include "GarbageCollectionTuning.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, TopDownStealth, "TopDownStealth" );
+class FTopDownStealthModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		FTopDownMemoryTracking::Startup();
+		FGameplayTrace::Startup();
+		FGarbageCollectionTuning::Startup();
+	}
+
+	virtual void ShutdownModule() override
+	{
+		FGarbageCollectionTuning::Shutdown();
+		FGameplayTrace::Shutdown();
+		FTopDownMemoryTracking::Shutdown();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FTopDownStealthModule, TopDownStealth, "TopDownStealth" );
 
 DEFINE_LOG_CATEGORY(LogTopDownStealth)
- 
\ No newline at end of file
@@ -5,3 +5,5 @@
 #include "CoreMinimal.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTopDownStealth, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("TopDownStealth"), STATGROUP_TopDownStealth, STATCAT_Advanced);
@@ -17,11 +17,16 @@
 #include "Engine/PointLight.h"
 #include "Engine/SpotLight.h"
 #include "Engine/DirectionalLight.h"
+#include "EngineUtils.h"
 #include "Runtime/Engine/Classes/Components/PointLightComponent.h"
 #include "Engine/World.h"
 #include "Engine/Public/TimerManager.h"
 #include "Animation/AnimInstance.h"
 #include "Pickup.h"
+#include "FactionSubsystem.h"
+#include "StealthLightingLibrary.h"
+#include "GameplayTrace.h"
+#include "TopDownMemoryTracking.h"
 
 ATopDownStealthCharacter::ATopDownStealthCharacter()
 {
@@ -76,6 +81,21 @@ void ATopDownStealthCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 	GetLights();
+
+	if (UFactionSubsystem* Factions = UFactionSubsystem::Get(this))
+	{
+		Factions->RegisterMember(this);
+	}
+}
+
+void ATopDownStealthCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UFactionSubsystem* Factions = UFactionSubsystem::Get(this))
+	{
+		Factions->UnregisterMember(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 //Runs every frame, fixes a bug with sprinting and runs the method to rotate the character to look at the mouse
@@ -106,42 +126,30 @@ void ATopDownStealthCharacter::Tick(float DeltaSeconds)
 //Light related methods and stuff
 void ATopDownStealthCharacter::UpdateInLight()
 {
-	bIsInLight = false;
+	const bool bWasInLight = bIsInLight;
+	bIsInLight = UStealthLightingLibrary::IsLocationInLight(this, GetActorLocation(), PointLights, this);
 
-	//Iterate through all lights in the scene
-	for (int32 i = 0; i < PointLights.Num(); i++)
+	if (bIsInLight != bWasInLight)
 	{
-		//Make sure it's a point light and it exists
-		APointLight* light = Cast<APointLight>(PointLights[i]);
-		if (light)
-		{
-			float distance = (light->GetActorLocation() - GetActorLocation()).Size();
-
-			//If the character is within the attenuation of the light (the light reaches the character)
-			if (distance < light->PointLightComponent->AttenuationRadius)
-			{
-				
-				FCollisionQueryParams collisionParams;
-				collisionParams.AddIgnoredActor(this);
-
-				FHitResult hitResult;
-
-				//Do a line trace from the light to the character to make sure they aren't behind anything, and if they aren't, then they're in the light
-				if (!GetWorld()->LineTraceSingleByChannel(hitResult, GetActorLocation(), light->GetActorLocation(), ECC_Visibility, collisionParams))
-				{
-					bIsInLight = true;
-				}
-
-			}
-		}
+		TRACE_GAMEPLAY_EVENT(LightStateChanged, GetActorLocation(), bIsInLight ? 1 : 0);
 	}
 }
 
 //Getting all the lights in the scene (just point and spot because that's all we need)
 void ATopDownStealthCharacter::GetLights()
 {
-	UGameplayStatics::GetAllActorsOfClass(this, APointLight::StaticClass(), PointLights);
-	UGameplayStatics::GetAllActorsOfClass(this, ASpotLight::StaticClass(), SpotLights);
+	TOPDOWN_LLM_SCOPE(Lights);
+	PointLights.Reset();
+	for (TActorIterator<APointLight> It(GetWorld()); It; ++It)
+	{
+		PointLights.Add(*It);
+	}
+
+	SpotLights.Reset();
+	for (TActorIterator<ASpotLight> It(GetWorld()); It; ++It)
+	{
+		SpotLights.Add(*It);
+	}
 }
 
 //Basic input initialization
@@ -238,6 +246,10 @@ void ATopDownStealthCharacter::DrawBow()
 		{
 			return;
 		}
+		else if (ArrowTypeNum == 4 && TeamSwitchArrowNum == 0)
+		{
+			return;
+		}
 
 		GetCharacterMovement()->MaxWalkSpeed = AimingSpeed;
 		bIsDrawingBow = true;
@@ -248,8 +260,6 @@ void ATopDownStealthCharacter::DrawBow()
 
 void ATopDownStealthCharacter::FireBow()
 {
-	UE_LOG(LogTemp, Warning, TEXT("Your message"));
-
 	if (!bIsSprinting && bIsAiming && bCanFire && !bIsDodging)
 	{
 		GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
@@ -278,8 +288,15 @@ void ATopDownStealthCharacter::FireBow()
 			arrowToFire = DissolveProjectileClass;
 			DissolveArrowNum--;
 		}
+		else if (ArrowTypeNum == 4)
+		{
+			arrowToFire = TeamSwitchProjectileClass;
+			TeamSwitchArrowNum--;
+		}
 
+		TOPDOWN_LLM_SCOPE(Arrows);
 		AArrowProjectile* arrow = GetWorld()->SpawnActor<AArrowProjectile>(arrowToFire, spawnLocation, spawnRotation, spawnParams);
+		TRACE_GAMEPLAY_EVENT(ArrowFired, spawnLocation, ArrowTypeNum);
 	}
 	else
 	{
@@ -300,6 +317,32 @@ void ATopDownStealthCharacter::CancelDraw()
 	}
 }
 
+void ATopDownStealthCharacter::TakeMeleeHit(const FMeleeHit& Hit)
+{
+	if (bIsDead)
+	{
+		return;
+	}
+
+	bGotHit = true;
+	Health = FMath::Max(Health - Hit.Damage, 0.0f);
+	CancelDraw();
+
+	if (Health <= 0.0f)
+	{
+		Die();
+	}
+	else
+	{
+		OnMeleeHit(Hit);
+	}
+}
+
+FGenericTeamId ATopDownStealthCharacter::GetGenericTeamId() const
+{
+	return FGenericTeamId((uint8)EFaction::Player);
+}
+
 void ATopDownStealthCharacter::Die()
 {
 	bIsDead = true;
@@ -4,10 +4,12 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "GenericTeamAgentInterface.h"
+#include "MeleeDamageable.h"
 #include "TopDownStealthCharacter.generated.h"
 
 UCLASS(Blueprintable)
-class ATopDownStealthCharacter : public ACharacter
+class ATopDownStealthCharacter : public ACharacter, public IMeleeDamageable, public IGenericTeamAgentInterface
 {
 	GENERATED_BODY()
 
@@ -71,6 +73,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Combat")
 	void Die();
 
+	//Called by the melee system when a guard's weapon connects
+	virtual void TakeMeleeHit(const FMeleeHit& Hit) override;
+
+	//Plays the hit reaction, bGotHit is already set when this is called
+	UFUNCTION(BlueprintImplementableEvent, Category = "Combat")
+	void OnMeleeHit(const FMeleeHit& Hit);
+
+	//The player is always on the player faction
+	virtual FGenericTeamId GetGenericTeamId() const override;
+
 	//Look at those booleans
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Movement)
 	bool bIsSprinting;
@@ -105,6 +117,8 @@ protected:
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 private:
 	/** Top down camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
@@ -164,17 +178,18 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = Weaponry, meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<class AArrowProjectile> DissolveProjectileClass;
 
+	UPROPERTY(EditDefaultsOnly, Category = Weaponry, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<class AArrowProjectile> TeamSwitchProjectileClass;
+
 	UPROPERTY(BlueprintReadWrite, Category = Animation, meta = (AllowPrivateAccess = "true"))
 	UAnimSequence* DeathAnim;
 
-	UPROPERTY()
-	TArray<AActor*> PointLights;
+	// Weak so the caches don't keep lights alive or add to the GC's reference graph, the level owns them
+	TArray<TWeakObjectPtr<class APointLight>> PointLights;
 
-	UPROPERTY()
-	TArray<AActor*> SpotLights;
+	TArray<TWeakObjectPtr<class ASpotLight>> SpotLights;
 
-	UPROPERTY()
-	TArray<AActor*> DirectionalLights;
+	TArray<TWeakObjectPtr<class ADirectionalLight>> DirectionalLights;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = Collision, meta = (AllowPrivateAccess = "true"))
 	TArray<TEnumAsByte<EObjectTypeQuery>> GroundPlane;
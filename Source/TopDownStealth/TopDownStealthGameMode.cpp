@@ -1,9 +1,26 @@
 // Copyright 1998-2018 Epic Games, Inc. All Rights Reserved.
 
 #include "TopDownStealthGameMode.h"
+#include "TopDownStealth.h"
 #include "TopDownStealthPlayerController.h"
 #include "TopDownStealthCharacter.h"
+#include "ArrowProjectile.h"
+#include "GuardCharacter.h"
+#include "Pickup.h"
+#include "BodyRegistrySubsystem.h"
+#include "GarbageCollectionTuning.h"
+#include "SignificanceComponent.h"
+#include "TopDownMemoryTracking.h"
 #include "UObject/ConstructorHelpers.h"
+#include "Engine/World.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/Engine.h"
+#include "EngineUtils.h"
+#include "TimerManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "HAL/PlatformMemory.h"
+#include "StatsReader.h"
 
 ATopDownStealthGameMode::ATopDownStealthGameMode()
 {
@@ -16,4 +33,283 @@ ATopDownStealthGameMode::ATopDownStealthGameMode()
 	{
 		DefaultPawnClass = PlayerPawnBPClass.Class;
 	}
-}
\ No newline at end of file
+
+	SoakTimeStep = 1.0f / 30.0f;
+	SoakDuration = 8.0f * 60.0f * 60.0f;
+	SoakSampleInterval = 60.0f;
+	SoakMemoryGrowthLimitMB = 256.0f;
+	SoakActorGrowthLimit = 200;
+
+	bSoakTest = false;
+	bSoakLeakDetected = false;
+	bSoakHasBaseline = false;
+	SoakStartWallTime = 0.0;
+	LastSampleWallTime = 0.0;
+	LastSampleGameTime = 0.0f;
+	BaselineMemory = 0;
+	BaselineArrows = 0;
+	BaselineBodies = 0;
+	BaselineActors = 0;
+
+	BenchmarkGuardCounts = { 10, 20, 40, 80, 160 };
+	BenchmarkFramesPerStep = 300;
+	bAnimBenchmark = false;
+	bBenchmarkIndividualAnimation = false;
+	BenchmarkStep = -1;
+	BenchmarkFrame = 0;
+	BenchmarkStepStartTime = 0.0;
+	BenchmarkLastFrameTime = 0.0;
+	BenchmarkWorstFrame = 0.0;
+	BenchmarkAnimEvalTotal = 0.0;
+	BenchmarkAnimEvalPeak = 0.0;
+	BenchmarkAnimGameThreadTotal = 0.0;
+
+	// Only ticks while the animation benchmark runs
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
+void ATopDownStealthGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	// Run with -Soak -nullrhi -nosound to simulate as fast as the CPU allows
+	bSoakTest = FParse::Param(FCommandLine::Get(), TEXT("Soak"));
+	// Run with -AnimBenchmark (plus -NoAnimSharing for the baseline) with rendering on, not -nullrhi: it runs in real time
+	// and guards that aren't rendered may skip their animation
+	bAnimBenchmark = FParse::Param(FCommandLine::Get(), TEXT("AnimBenchmark"));
+	bBenchmarkIndividualAnimation = FParse::Param(FCommandLine::Get(), TEXT("NoAnimSharing"));
+	if (!bSoakTest)
+	{
+		return;
+	}
+
+	FParse::Value(FCommandLine::Get(), TEXT("SoakStep="), SoakTimeStep);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakDuration="), SoakDuration);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakSampleInterval="), SoakSampleInterval);
+	FParse::Value(FCommandLine::Get(), TEXT("SoakMemoryLimitMB="), SoakMemoryGrowthLimitMB);
+
+	// Every frame advances the world by the same amount and the engine doesn't wait between frames
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(SoakTimeStep);
+}
+
+void ATopDownStealthGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	// The benchmark runs in real time with rendering on, guards that aren't rendered may skip their animation
+	if (bAnimBenchmark)
+	{
+		// Turns on the anim stat group so the benchmark can read its timings every frame
+		GEngine->Exec(GetWorld(), TEXT("stat anim"));
+
+		SetActorTickEnabled(true);
+		StartBenchmarkStep();
+	}
+
+	if (!bSoakTest)
+	{
+		return;
+	}
+
+	if (UGameViewportClient* Viewport = GetWorld()->GetGameViewport())
+	{
+		Viewport->bDisableWorldRendering = true;
+	}
+
+	// The GC report reads the engine's incremental purge time from this group
+	GEngine->Exec(GetWorld(), TEXT("stat gc"));
+
+	SoakStartWallTime = FPlatformTime::Seconds();
+	LastSampleWallTime = SoakStartWallTime;
+	LastSampleGameTime = GetWorld()->GetTimeSeconds();
+
+	UE_LOG(LogTopDownStealth, Display, TEXT("Soak test started: %.4fs step, %.0fs duration, sampling every %.0fs"), SoakTimeStep, SoakDuration, SoakSampleInterval);
+
+	GetWorldTimerManager().SetTimer(SoakTimerHandle, this, &ATopDownStealthGameMode::SampleSoak, SoakSampleInterval, true);
+}
+
+void ATopDownStealthGameMode::SampleSoak()
+{
+	UWorld* World = GetWorld();
+
+	const double WallTime = FPlatformTime::Seconds();
+	const float GameTime = World->GetTimeSeconds();
+	const double WallDelta = FMath::Max(WallTime - LastSampleWallTime, 0.001);
+	const double TotalWall = FMath::Max(WallTime - SoakStartWallTime, 0.001);
+
+	const float Throughput = (float)((GameTime - LastSampleGameTime) / WallDelta);
+	const float AverageThroughput = (float)(GameTime / TotalWall);
+
+	LastSampleWallTime = WallTime;
+	LastSampleGameTime = GameTime;
+
+	int32 Actors = 0;
+	int32 Arrows = 0;
+	int32 Pickups = 0;
+	int32 Guards = 0;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		Actors++;
+		if (It->IsA<AArrowProjectile>())
+		{
+			Arrows++;
+		}
+		else if (It->IsA<APickup>())
+		{
+			Pickups++;
+		}
+		else if (It->IsA<AGuardCharacter>())
+		{
+			Guards++;
+		}
+	}
+
+	UBodyRegistrySubsystem* BodyRegistry = UBodyRegistrySubsystem::Get(this);
+	const int32 Bodies = BodyRegistry ? BodyRegistry->GetNumBodies() : 0;
+	const uint64 Memory = FPlatformMemory::GetStats().UsedPhysical;
+
+	UE_LOG(LogTopDownStealth, Display, TEXT("Soak %.0fs: %.1f sim s/wall s (avg %.1f), %.1f MB, %d actors (%d arrows, %d pickups, %d guards, %d bodies)"),
+		GameTime, Throughput, AverageThroughput, Memory / (1024.0 * 1024.0), Actors, Arrows, Pickups, Guards, Bodies);
+
+	// Compare runs with -dpcvars=gc.ActorClusteringEnabled=0,gc.IncrementalBeginDestroyEnabled=0 to see what clustering and spread out destruction save
+	const FGarbageCollectionReport& GCReport = FGarbageCollectionTuning::GetReport();
+	UE_LOG(LogTopDownStealth, Display, TEXT("Soak %.0fs: %d GCs, mark %.2f ms max (%.1f ms total), purge %.2f ms max frame (%.1f ms total over %d frames), %d full purge GCs %.2f ms max"),
+		GameTime, GCReport.Collections, GCReport.MaxMarkMs, GCReport.TotalMarkMs, GCReport.MaxPurgeFrameMs, GCReport.TotalPurgeMs, GCReport.PurgeFrames,
+		GCReport.FullPurgeCollections, GCReport.MaxFullPurgeCollectMs);
+	FGarbageCollectionTuning::ResetReport();
+
+	// The first sample is the baseline, the level has finished loading by then
+	if (!bSoakHasBaseline)
+	{
+		bSoakHasBaseline = true;
+		BaselineMemory = Memory;
+		BaselineArrows = Arrows;
+		BaselineBodies = Bodies;
+		BaselineActors = Actors;
+	}
+	else
+	{
+		const float MemoryGrowthMB = (float)(((int64)Memory - (int64)BaselineMemory) / (1024.0 * 1024.0));
+		if (MemoryGrowthMB > SoakMemoryGrowthLimitMB)
+		{
+			UE_LOG(LogTopDownStealth, Error, TEXT("Soak: memory grew %.1f MB since the first sample"), MemoryGrowthMB);
+			bSoakLeakDetected = true;
+		}
+
+		if (Arrows - BaselineArrows > SoakActorGrowthLimit || Bodies - BaselineBodies > SoakActorGrowthLimit || Actors - BaselineActors > SoakActorGrowthLimit)
+		{
+			UE_LOG(LogTopDownStealth, Error, TEXT("Soak: actor counts keep growing (%+d actors, %+d arrows, %+d bodies)"),
+				Actors - BaselineActors, Arrows - BaselineArrows, Bodies - BaselineBodies);
+			bSoakLeakDetected = true;
+		}
+	}
+
+	if (SoakDuration > 0.0f && GameTime >= SoakDuration)
+	{
+		UE_LOG(LogTopDownStealth, Display, TEXT("Soak test %s after %.0f simulated seconds in %.0f wall seconds"),
+			bSoakLeakDetected ? TEXT("FAILED") : TEXT("passed"), GameTime, TotalWall);
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void ATopDownStealthGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!bAnimBenchmark || BenchmarkStep < 0)
+	{
+		return;
+	}
+
+	static const int32 WarmUpFrames = 30;
+
+	const double Now = FPlatformTime::Seconds();
+	BenchmarkFrame++;
+
+	if (BenchmarkFrame == WarmUpFrames)
+	{
+		BenchmarkStepStartTime = Now;
+		BenchmarkWorstFrame = 0.0;
+		BenchmarkAnimEvalTotal = 0.0;
+		BenchmarkAnimEvalPeak = 0.0;
+		BenchmarkAnimGameThreadTotal = 0.0;
+	}
+	else if (BenchmarkFrame > WarmUpFrames)
+	{
+		BenchmarkWorstFrame = FMath::Max(BenchmarkWorstFrame, Now - BenchmarkLastFrameTime);
+
+		// Pose evaluation runs on the task graph workers, the rest of the anim update on the game thread
+		static const FName AnimEvalStat(TEXT("STAT_PerformAnimEvaluation"));
+		static const FName AnimGameThreadStat(TEXT("STAT_AnimGameThreadTime"));
+
+		const double AnimEvalMs = FStatsReader::GetLatestMs(AnimEvalStat);
+		BenchmarkAnimEvalTotal += AnimEvalMs;
+		BenchmarkAnimEvalPeak = FMath::Max(BenchmarkAnimEvalPeak, AnimEvalMs);
+		BenchmarkAnimGameThreadTotal += FStatsReader::GetLatestMs(AnimGameThreadStat);
+	}
+	BenchmarkLastFrameTime = Now;
+
+	if (BenchmarkFrame >= WarmUpFrames + BenchmarkFramesPerStep)
+	{
+		FinishBenchmarkStep();
+		StartBenchmarkStep();
+	}
+}
+
+void ATopDownStealthGameMode::StartBenchmarkStep()
+{
+	BenchmarkStep++;
+	BenchmarkFrame = 0;
+
+	if (!BenchmarkGuardClass || !BenchmarkGuardCounts.IsValidIndex(BenchmarkStep))
+	{
+		if (!BenchmarkGuardClass)
+		{
+			UE_LOG(LogTopDownStealth, Error, TEXT("Anim benchmark: no BenchmarkGuardClass set on the game mode"));
+		}
+		BenchmarkStep = -1;
+		FPlatformMisc::RequestExit(false);
+		return;
+	}
+
+	// Guards stand in a grid around the player start, far enough apart not to push each other
+	const AActor* Start = FindPlayerStart(nullptr);
+	const FVector Origin = Start ? Start->GetActorLocation() : FVector::ZeroVector;
+	const int32 Columns = 16;
+
+	while (BenchmarkGuards.Num() < BenchmarkGuardCounts[BenchmarkStep])
+	{
+		const int32 Index = BenchmarkGuards.Num();
+		const FVector Location = Origin + FVector((Index / Columns) * 150.0f + 300.0f, (Index % Columns - Columns / 2) * 150.0f, 0.0f);
+
+		// Around the whole spawn so the actor, its components and its AI controller count towards the AI budget
+		TOPDOWN_LLM_SCOPE(AI);
+
+		AGuardCharacter* Guard = GetWorld()->SpawnActorDeferred<AGuardCharacter>(BenchmarkGuardClass, FTransform(Location), nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (!Guard)
+		{
+			break;
+		}
+		Guard->bUseAnimationSharing = !bBenchmarkIndividualAnimation;
+		// The grid reaches past the camera footprint, idle guards out there would go dormant and stop animating
+		if (USignificanceComponent* Significance = Guard->GetSignificance())
+		{
+			Significance->bCullingEnabled = false;
+		}
+		Guard->FinishSpawning(FTransform(Location));
+		BenchmarkGuards.Add(Guard);
+	}
+}
+
+void ATopDownStealthGameMode::FinishBenchmarkStep()
+{
+	const int32 Frames = FMath::Max(BenchmarkFramesPerStep, 1);
+	const double Elapsed = FPlatformTime::Seconds() - BenchmarkStepStartTime;
+	const double AverageMs = Elapsed * 1000.0 / Frames;
+
+	UE_LOG(LogTopDownStealth, Display, TEXT("Anim benchmark (%s): %4d guards, anim eval %.2f ms/frame avg (%.2f ms peak), anim game thread %.2f ms/frame, frame %.2f ms avg (%.2f ms worst)"),
+		bBenchmarkIndividualAnimation ? TEXT("individual") : TEXT("shared"), BenchmarkGuards.Num(),
+		BenchmarkAnimEvalTotal / Frames, BenchmarkAnimEvalPeak, BenchmarkAnimGameThreadTotal / Frames, AverageMs, BenchmarkWorstFrame * 1000.0);
+}
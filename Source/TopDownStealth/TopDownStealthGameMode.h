@@ -13,7 +13,102 @@ class ATopDownStealthGameMode : public AGameModeBase
 
 public:
 	ATopDownStealthGameMode();
-};
 
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void StartPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** True when the game was started as a headless soak test (-Soak). */
+	UFUNCTION(BlueprintPure, Category = "Soak")
+	bool IsSoakTest() const { return bSoakTest; }
+
+protected:
+	/** Simulated seconds per frame in a soak test, overridden by -SoakStep= */
+	UPROPERTY(EditDefaultsOnly, Category = "Soak")
+	float SoakTimeStep;
+
+	/** Simulated seconds to run before quitting, overridden by -SoakDuration= (0 runs until killed) */
+	UPROPERTY(EditDefaultsOnly, Category = "Soak")
+	float SoakDuration;
+
+	/** Simulated seconds between throughput, memory and actor count samples, overridden by -SoakSampleInterval= */
+	UPROPERTY(EditDefaultsOnly, Category = "Soak")
+	float SoakSampleInterval;
+
+	/** Memory growth over the first sample that counts as a leak, overridden by -SoakMemoryLimitMB= */
+	UPROPERTY(EditDefaultsOnly, Category = "Soak")
+	float SoakMemoryGrowthLimitMB;
+
+	/** Growth in arrows or bodies over the first sample that counts as a leak */
+	UPROPERTY(EditDefaultsOnly, Category = "Soak")
+	int32 SoakActorGrowthLimit;
+
+	/** Guard spawned by the animation benchmark (-AnimBenchmark) */
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	TSubclassOf<class AGuardCharacter> BenchmarkGuardClass;
+
+	/** Guard counts the animation benchmark steps through */
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	TArray<int32> BenchmarkGuardCounts;
+
+	/** Frames measured at each guard count, after a short warm up */
+	UPROPERTY(EditDefaultsOnly, Category = "Benchmark")
+	int32 BenchmarkFramesPerStep;
+
+private:
+	/** Spawns guards up to the next count and starts measuring, or quits when done. */
+	void StartBenchmarkStep();
+
+	/** Logs the frame and animation evaluation times of the step that just finished. */
+	void FinishBenchmarkStep();
+
+	/** Logs throughput, memory and actor counts, and flags anything that keeps growing. */
+	void SampleSoak();
+
+	bool bSoakTest;
+
+	bool bSoakLeakDetected;
+
+	bool bSoakHasBaseline;
+
+	double SoakStartWallTime;
 
+	double LastSampleWallTime;
 
+	float LastSampleGameTime;
+
+	uint64 BaselineMemory;
+
+	int32 BaselineArrows;
+
+	int32 BaselineBodies;
+
+	int32 BaselineActors;
+
+	FTimerHandle SoakTimerHandle;
+
+	bool bAnimBenchmark;
+
+	/** Spawned guards don't use animation sharing (-NoAnimSharing), to compare against */
+	bool bBenchmarkIndividualAnimation;
+
+	int32 BenchmarkStep;
+
+	int32 BenchmarkFrame;
+
+	double BenchmarkStepStartTime;
+
+	double BenchmarkLastFrameTime;
+
+	double BenchmarkWorstFrame;
+
+	/** Sums and peak of the per frame animation stats, in ms */
+	double BenchmarkAnimEvalTotal;
+
+	double BenchmarkAnimEvalPeak;
+
+	double BenchmarkAnimGameThreadTotal;
+
+	UPROPERTY()
+	TArray<class AGuardCharacter*> BenchmarkGuards;
+};
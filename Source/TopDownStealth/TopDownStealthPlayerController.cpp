@@ -6,6 +6,8 @@
 #include "HeadMountedDisplayFunctionLibrary.h"
 #include "TopDownStealthCharacter.h"
 #include "Engine/World.h"
+#include "SignificanceManager.h"
+#include "GameplayTrace.h"
 
 ATopDownStealthPlayerController::ATopDownStealthPlayerController()
 {
@@ -22,6 +24,22 @@ void ATopDownStealthPlayerController::PlayerTick(float DeltaTime)
 	{
 		MoveToMouseCursor();
 	}
+
+	UpdateSignificance();
+}
+
+void ATopDownStealthPlayerController::UpdateSignificance()
+{
+	if (USignificanceManager* Significance = USignificanceManager::Get(GetWorld()))
+	{
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		TArray<FTransform, TInlineAllocator<1>> Viewpoints;
+		Viewpoints.Emplace(ViewRotation, ViewLocation);
+		Significance->Update(Viewpoints);
+	}
 }
 
 void ATopDownStealthPlayerController::SetupInputComponent()
@@ -87,6 +105,7 @@ void ATopDownStealthPlayerController::SetNewMoveDestination(const FVector DestLo
 		// We need to issue move command only if far enough in order for walk animation to play correctly
 		if ((Distance > 120.0f))
 		{
+			TRACE_GAMEPLAY_EVENT(PathRequested, DestLocation, FMath::RoundToInt(Distance));
 			UAIBlueprintHelperLibrary::SimpleMoveToLocation(this, DestLocation);
 		}
 	}
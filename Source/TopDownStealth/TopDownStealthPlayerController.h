@@ -32,6 +32,9 @@ protected:
 	/** Navigate player to the current touch location. */
 	void MoveToTouchLocation(const ETouchIndex::Type FingerIndex, const FVector Location);
 	
+	/** Scores actors against what the camera can currently see. */
+	void UpdateSignificance();
+
 	/** Navigate player to the given world location. */
 	void SetNewMoveDestination(const FVector DestLocation);
 